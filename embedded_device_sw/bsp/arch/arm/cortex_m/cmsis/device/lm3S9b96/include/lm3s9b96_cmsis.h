@@ -0,0 +1,56 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LM3S9B96_CMSIS_H__
+#define __LM3S9B96_CMSIS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   CMSIS device definitions of the LM3S9B96.
+ *
+ * @note    lm3s9b96.h only holds the register addresses of the StellarisWare
+ *          drivers, this header gives the core peripherals of core_cm3.h.
+ *          The peripheral interrupts keep the INT_* numbers of hw_ints.h.
+ */
+typedef enum {
+	NonMaskableInt_IRQn	= -14,
+	HardFault_IRQn		= -13,
+	MemoryManagement_IRQn	= -12,
+	BusFault_IRQn		= -11,
+	UsageFault_IRQn		= -10,
+	SVCall_IRQn		= -5,
+	DebugMonitor_IRQn	= -4,
+	PendSV_IRQn		= -2,
+	SysTick_IRQn		= -1,
+} IRQn_Type;
+
+#define __CM3_REV		0x0200U
+#define __MPU_PRESENT		1U
+#define __NVIC_PRIO_BITS	3U
+#define __Vendor_SysTickConfig	0U
+
+#include "core_cm3.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __LM3S9B96_CMSIS_H__ */
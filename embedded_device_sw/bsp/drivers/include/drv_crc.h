@@ -59,8 +59,13 @@ typedef struct {
 
 /**
  * @brief   CRC interface definitions.
+ *
+ * @note    The unit is shared, a user takes it with lock, installs its own
+ *          configuration and computes before giving it back with unlock.
  */
 typedef struct {
+	int (*lock)(const object *obj, unsigned int timeout);
+	int (*unlock)(const object *obj);
 	int (*configure)(const object *obj, const crc_config_t *config);
 	int (*calculate)(const object *obj, const void *buf, int len,
 			 unsigned int *crc);
@@ -68,6 +73,51 @@ typedef struct {
 			  unsigned int *crc);
 } crc_intf_t;
 
+/**
+ * @brief   Take the unit for the calling thread.
+ *
+ * @param   obj Pointer to the CRC object handle.
+ * @param   timeout Timeout in ticks, osWaitForever to wait forever.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int crc_lock(const object *obj, unsigned int timeout)
+{
+	crc_intf_t *intf;
+
+	if (!obj)
+		return -EINVAL;
+
+	intf = (crc_intf_t *)obj->object_intf;
+	if ((intf == NULL)
+	    || (intf->lock == NULL))
+		return -ENOSUPPORT;
+
+	return intf->lock(obj, timeout);
+}
+
+/**
+ * @brief   Give the unit back.
+ *
+ * @param   obj Pointer to the CRC object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int crc_unlock(const object *obj)
+{
+	crc_intf_t *intf;
+
+	if (!obj)
+		return -EINVAL;
+
+	intf = (crc_intf_t *)obj->object_intf;
+	if ((intf == NULL)
+	    || (intf->unlock == NULL))
+		return -ENOSUPPORT;
+
+	return intf->unlock(obj);
+}
+
 /**
  * @brief   Install one hardware configuration from a configuration space.
  *
@@ -26,6 +26,7 @@
 #include "driverlib/rom.h"
 #include "driverlib/rom_map.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/cpu.h"
 
 #if defined(CONFIG_CLOCK_ENABLE)
 
@@ -91,6 +92,10 @@ typedef struct {
  * @param   id Device id.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    The RCGC registers are shared by all the sub-systems and the
+ *          objects may be probed concurrently, so the nesting counter and
+ *          the read-modify-write of the register are done atomically.
  */
 static int lm3s9xxx_clock_on(const object *	obj,
 			     clock_subsys_t	sys,
@@ -99,7 +104,9 @@ static int lm3s9xxx_clock_on(const object *	obj,
 	lm3s9xxx_clock_handle_t *handle =
 		(lm3s9xxx_clock_handle_t *)obj->object_data;
 	unsigned long peripheral_base;
+	unsigned long masked;
 	int index;
+	int ret = 0;
 
 	if (!handle)
 		return -EINVAL;
@@ -108,15 +115,21 @@ static int lm3s9xxx_clock_on(const object *	obj,
 	if (index < 0)
 		return index;
 
-	if (handle->clock_subsys_onoff_nesting[index] + 1 == 0)
-		return -EBUSY;
+	masked = CPUcpsid();
 
-	if (handle->clock_subsys_onoff_nesting[index] == 0)
-		MAP_SysCtlPeripheralEnable(peripheral_base);
+	if (handle->clock_subsys_onoff_nesting[index] + 1 == 0) {
+		ret = -EBUSY;
+	} else {
+		if (handle->clock_subsys_onoff_nesting[index] == 0)
+			MAP_SysCtlPeripheralEnable(peripheral_base);
 
-	handle->clock_subsys_onoff_nesting[index]++;
+		handle->clock_subsys_onoff_nesting[index]++;
+	}
 
-	return 0;
+	if (!masked)
+		(void)CPUcpsie();
+
+	return ret;
 }
 
 /**
@@ -127,6 +140,8 @@ static int lm3s9xxx_clock_on(const object *	obj,
  * @param   id Device id.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    Done atomically, see lm3s9xxx_clock_on().
  */
 static int lm3s9xxx_clock_off(const object *	obj,
 			      clock_subsys_t	sys,
@@ -135,7 +150,9 @@ static int lm3s9xxx_clock_off(const object *	obj,
 	lm3s9xxx_clock_handle_t *handle =
 		(lm3s9xxx_clock_handle_t *)obj->object_data;
 	unsigned long peripheral_base;
+	unsigned long masked;
 	int index;
+	int ret = 0;
 
 	if (!handle)
 		return -EINVAL;
@@ -144,15 +161,21 @@ static int lm3s9xxx_clock_off(const object *	obj,
 	if (index < 0)
 		return index;
 
-	if (handle->clock_subsys_onoff_nesting[index] == 0)
-		return -EIO;
+	masked = CPUcpsid();
 
-	handle->clock_subsys_onoff_nesting[index]--;
+	if (handle->clock_subsys_onoff_nesting[index] == 0) {
+		ret = -EIO;
+	} else {
+		handle->clock_subsys_onoff_nesting[index]--;
 
-	if (handle->clock_subsys_onoff_nesting[index] == 0)
-		MAP_SysCtlPeripheralDisable(peripheral_base);
+		if (handle->clock_subsys_onoff_nesting[index] == 0)
+			MAP_SysCtlPeripheralDisable(peripheral_base);
+	}
 
-	return 0;
+	if (!masked)
+		(void)CPUcpsie();
+
+	return ret;
 }
 
 /**
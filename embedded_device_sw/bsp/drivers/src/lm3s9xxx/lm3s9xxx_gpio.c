@@ -350,6 +350,10 @@ module_driver(CONFIG_GPIOA_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpioa_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOA_NAME,
+		       CONFIG_GPIOA_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOB_NAME
@@ -365,6 +369,10 @@ module_driver(CONFIG_GPIOB_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpiob_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOB_NAME,
+		       CONFIG_GPIOB_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOC_NAME
@@ -380,6 +388,10 @@ module_driver(CONFIG_GPIOC_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpioc_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOC_NAME,
+		       CONFIG_GPIOC_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOD_NAME
@@ -395,6 +407,10 @@ module_driver(CONFIG_GPIOD_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpiod_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOD_NAME,
+		       CONFIG_GPIOD_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOE_NAME
@@ -410,6 +426,10 @@ module_driver(CONFIG_GPIOE_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpioe_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOE_NAME,
+		       CONFIG_GPIOE_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOF_NAME
@@ -425,6 +445,10 @@ module_driver(CONFIG_GPIOF_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpiof_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOF_NAME,
+		       CONFIG_GPIOF_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOG_NAME
@@ -440,6 +464,10 @@ module_driver(CONFIG_GPIOG_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpiog_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOG_NAME,
+		       CONFIG_GPIOG_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOH_NAME
@@ -455,6 +483,10 @@ module_driver(CONFIG_GPIOH_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpioh_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOH_NAME,
+		       CONFIG_GPIOH_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOJ_NAME
@@ -470,4 +502,8 @@ module_driver(CONFIG_GPIOJ_NAME,
 	      lm3s9xxx_gpio_probe,
 	      lm3s9xxx_gpio_shutdown,
 	      &gpio_intf, &gpioj_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOJ_NAME,
+		       CONFIG_GPIOJ_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
@@ -466,4 +466,8 @@ module_early_driver(CONFIG_UART0_NAME,
 		    lm3s9xxx_uart0_shutdown,
 		    &uart0_intf, &uart0_handle, &uart0_config);
 
+DECLARE_OBJECT_DEPENDS(CONFIG_UART0_NAME,
+		       CONFIG_UART0_LABEL,
+		       CONFIG_CLOCK_NAME);
+
 #endif
@@ -184,6 +184,10 @@ typedef struct {
  * @param   id Device id.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    The enable registers are shared by all the sub-systems and the
+ *          objects may be probed concurrently, so the nesting counter and
+ *          the read-modify-write of the register are done atomically.
  */
 static int stm32wbxx_clock_on(const object *	obj,
 			      clock_subsys_t	sys,
@@ -192,8 +196,9 @@ static int stm32wbxx_clock_on(const object *	obj,
 	stm32wbxx_clock_handle_t *handle =
 		(stm32wbxx_clock_handle_t *)obj->object_data;
 	subsys_onoff_t subsys_onoff;
+	uint32_t primask;
 	int index;
-	int ret;
+	int ret = 0;
 
 	if (!handle)
 		return -EINVAL;
@@ -202,18 +207,20 @@ static int stm32wbxx_clock_on(const object *	obj,
 	if (index < 0)
 		return index;
 
-	if (handle->clock_subsys_onoff_nesting[index] + 1 == 0)
-		return -EBUSY;
+	primask = __get_PRIMASK();
+	__disable_irq();
 
-	if (handle->clock_subsys_onoff_nesting[index] == 0) {
+	if (handle->clock_subsys_onoff_nesting[index] + 1 == 0)
+		ret = -EBUSY;
+	else if (handle->clock_subsys_onoff_nesting[index] == 0)
 		ret = subsys_onoff(sys, id, 1);
-		if (ret)
-			return ret;
-	}
 
-	handle->clock_subsys_onoff_nesting[index]++;
+	if (!ret)
+		handle->clock_subsys_onoff_nesting[index]++;
 
-	return 0;
+	__set_PRIMASK(primask);
+
+	return ret;
 }
 
 /**
@@ -224,6 +231,8 @@ static int stm32wbxx_clock_on(const object *	obj,
  * @param   id Device id.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    Done atomically, see stm32wbxx_clock_on().
  */
 static int stm32wbxx_clock_off(const object *	obj,
 			       clock_subsys_t	sys,
@@ -232,8 +241,9 @@ static int stm32wbxx_clock_off(const object *	obj,
 	stm32wbxx_clock_handle_t *handle =
 		(stm32wbxx_clock_handle_t *)obj->object_data;
 	subsys_onoff_t subsys_onoff;
+	uint32_t primask;
 	int index;
-	int ret;
+	int ret = 0;
 
 	if (!handle)
 		return -EINVAL;
@@ -242,18 +252,21 @@ static int stm32wbxx_clock_off(const object *	obj,
 	if (index < 0)
 		return index;
 
-	if (handle->clock_subsys_onoff_nesting[index] == 0)
-		return -EIO;
-
-	handle->clock_subsys_onoff_nesting[index]--;
+	primask = __get_PRIMASK();
+	__disable_irq();
 
 	if (handle->clock_subsys_onoff_nesting[index] == 0) {
-		ret = subsys_onoff(sys, id, 0);
-		if (ret)
-			return ret;
+		ret = -EIO;
+	} else {
+		handle->clock_subsys_onoff_nesting[index]--;
+
+		if (handle->clock_subsys_onoff_nesting[index] == 0)
+			ret = subsys_onoff(sys, id, 0);
 	}
 
-	return 0;
+	__set_PRIMASK(primask);
+
+	return ret;
 }
 
 /**
@@ -29,12 +29,63 @@
 
 /**
  * @brief   CRC handle definition.
+ *
+ * @note    The mutex keeps the configuration of a user installed in the
+ *          unit until its computation is done.
  */
 typedef struct {
 	CRC_HandleTypeDef	crc;
 	const object *		clock;
+	osMutexId_t		mutex_id;
 } stm32wbxx_crc_handle_t;
 
+/**
+ * @brief   Take the unit for the calling thread.
+ *
+ * @param   obj Pointer to the CRC object handle.
+ * @param   timeout Timeout in ticks, osWaitForever to wait forever.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int stm32wbxx_crc_lock(const object *obj, unsigned int timeout)
+{
+	stm32wbxx_crc_handle_t *handle =
+		(stm32wbxx_crc_handle_t *)obj->object_data;
+	osStatus_t status;
+
+	if (!handle || !handle->mutex_id)
+		return -EINVAL;
+
+	status = osMutexAcquire(handle->mutex_id, timeout);
+	if (status == osErrorTimeout || status == osErrorResource)
+		return -ETIMEDOUT;
+	else if (status != osOK)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief   Give the unit back.
+ *
+ * @param   obj Pointer to the CRC object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int stm32wbxx_crc_unlock(const object *obj)
+{
+	stm32wbxx_crc_handle_t *handle =
+		(stm32wbxx_crc_handle_t *)obj->object_data;
+
+	if (!handle || !handle->mutex_id)
+		return -EINVAL;
+
+	if (osMutexRelease(handle->mutex_id) != osOK)
+		return -EPERM;
+
+	return 0;
+}
+
 /**
  * @brief   Install one hardware configuration from a configuration space.
  *
@@ -178,6 +229,8 @@ static int stm32wbxx_crc_accumulate(const object *obj,
 
 static crc_intf_t crc_intf =
 {
+	.lock		= stm32wbxx_crc_lock,
+	.unlock		= stm32wbxx_crc_unlock,
 	.configure	= stm32wbxx_crc_configure,
 	.calculate	= stm32wbxx_crc_calculate,
 	.accumulate	= stm32wbxx_crc_accumulate,
@@ -185,6 +238,13 @@ static crc_intf_t crc_intf =
 
 static stm32wbxx_crc_handle_t crc_handle;
 
+static const osMutexAttr_t crc_mutex_attr = {
+	.name		= CONFIG_CRC_MUTEX_NAME,
+	.attr_bits	= osMutexPrioInherit,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+};
+
 static crc_config_t crc_config =
 {
 	.initial_value	= CONFIG_CRC_HW_INITIAL_VALUE,
@@ -229,6 +289,10 @@ static int stm32wbxx_crc_probe(const object *obj)
 	if (ret)
 		return ret;
 
+	handle->mutex_id = osMutexNew(&crc_mutex_attr);
+	if (!handle->mutex_id)
+		return -ENOMEM;
+
 	pr_info("Object <%s> probe succeed.", obj->name);
 
 	return 0;
@@ -250,6 +314,11 @@ static int stm32wbxx_crc_shutdown(const object *obj)
 	if (HAL_CRC_DeInit(&handle->crc) != HAL_OK)
 		return -EIO;
 
+	if (handle->mutex_id) {
+		(void)osMutexDelete(handle->mutex_id);
+		handle->mutex_id = NULL;
+	}
+
 	ret = clock_off(handle->clock, DRV_CLK_CRC, 0);
 	if (ret)
 		return ret;
@@ -259,10 +328,15 @@ static int stm32wbxx_crc_shutdown(const object *obj)
 	return 0;
 }
 
-module_driver(CONFIG_CRC_NAME,
-	      CONFIG_CRC_LABEL,
-	      stm32wbxx_crc_probe,
-	      stm32wbxx_crc_shutdown,
-	      &crc_intf, &crc_handle, &crc_config);
+/* Only a few users, it is probed on first use and off when idle */
+module_driver_lazy(CONFIG_CRC_NAME,
+		   CONFIG_CRC_LABEL,
+		   stm32wbxx_crc_probe,
+		   stm32wbxx_crc_shutdown,
+		   &crc_intf, &crc_handle, &crc_config);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_CRC_NAME,
+		       CONFIG_CRC_LABEL,
+		       CONFIG_CLOCK_NAME);
 
 #endif
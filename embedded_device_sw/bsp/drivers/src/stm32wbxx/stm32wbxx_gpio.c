@@ -341,6 +341,10 @@ module_driver(CONFIG_GPIOA_NAME,
 	      stm32wbxx_gpio_probe,
 	      stm32wbxx_gpio_shutdown,
 	      &gpio_intf, &gpioa_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOA_NAME,
+		       CONFIG_GPIOA_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOB_NAME
@@ -356,6 +360,10 @@ module_driver(CONFIG_GPIOB_NAME,
 	      stm32wbxx_gpio_probe,
 	      stm32wbxx_gpio_shutdown,
 	      &gpio_intf, &gpiob_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOB_NAME,
+		       CONFIG_GPIOB_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOC_NAME
@@ -371,6 +379,10 @@ module_driver(CONFIG_GPIOC_NAME,
 	      stm32wbxx_gpio_probe,
 	      stm32wbxx_gpio_shutdown,
 	      &gpio_intf, &gpioc_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOC_NAME,
+		       CONFIG_GPIOC_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOD_NAME
@@ -386,6 +398,10 @@ module_driver(CONFIG_GPIOD_NAME,
 	      stm32wbxx_gpio_probe,
 	      stm32wbxx_gpio_shutdown,
 	      &gpio_intf, &gpiod_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOD_NAME,
+		       CONFIG_GPIOD_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
 
 #ifdef CONFIG_GPIOE_NAME
@@ -401,4 +417,8 @@ module_driver(CONFIG_GPIOE_NAME,
 	      stm32wbxx_gpio_probe,
 	      stm32wbxx_gpio_shutdown,
 	      &gpio_intf, &gpioe_handle, NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_GPIOE_NAME,
+		       CONFIG_GPIOE_LABEL,
+		       CONFIG_CLOCK_NAME);
 #endif
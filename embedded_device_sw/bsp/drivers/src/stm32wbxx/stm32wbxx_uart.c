@@ -32,6 +32,10 @@
 
 /**
  * @brief   Uart handle definition.
+ *
+ * @note    The port is shared by the traces and the service bridge, the
+ *          mutex serializes the threads using the ring buffers, which are
+ *          only safe against the interrupt handler of the port.
  */
 typedef struct {
 #ifdef CONFIG_UART1_TX_RING_BUFF_SIZE
@@ -42,8 +46,72 @@ typedef struct {
 #endif
 	UART_HandleTypeDef	uart;
 	const object *		clock;
+	osMutexId_t		mutex_id;
 } stm32wbxx_uart_handle_t;
 
+/**
+ * @brief   Take the port for the calling thread.
+ *
+ * @param   handle Pointer to the uart driver handle.
+ *
+ * @retval  Returns 1 if the mutex was taken, 0 otherwise.
+ *
+ * @note    Interrupt handlers, and the code running before the kernel, use
+ *          the port without the mutex.
+ */
+static int stm32wbxx_uart_lock(stm32wbxx_uart_handle_t *handle)
+{
+	if (!handle->mutex_id || __get_IPSR()
+	    || osKernelGetState() != osKernelRunning)
+		return 0;
+
+	return osMutexAcquire(handle->mutex_id, osWaitForever) == osOK;
+}
+
+/**
+ * @brief   Give the port back.
+ *
+ * @param   handle Pointer to the uart driver handle.
+ * @param   locked Result of stm32wbxx_uart_lock().
+ *
+ * @retval  None.
+ */
+static void stm32wbxx_uart_unlock(stm32wbxx_uart_handle_t *	handle,
+				  int				locked)
+{
+	if (locked)
+		(void)osMutexRelease(handle->mutex_id);
+}
+
+/**
+ * @brief   Mask the interrupt of the port.
+ *
+ * @param   None.
+ *
+ * @retval  Returns 1 if the interrupt was enabled, 0 otherwise.
+ */
+static uint32_t stm32wbxx_uart_irq_save(void)
+{
+	uint32_t enabled = NVIC_GetEnableIRQ(USART1_IRQn);
+
+	HAL_NVIC_DisableIRQ(USART1_IRQn);
+
+	return enabled;
+}
+
+/**
+ * @brief   Restore the interrupt of the port as it was before the mask.
+ *
+ * @param   enabled Result of stm32wbxx_uart_irq_save().
+ *
+ * @retval  None.
+ */
+static void stm32wbxx_uart_irq_restore(uint32_t enabled)
+{
+	if (enabled)
+		HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
 /**
  * @brief   Install one hardware configuration from a configuration space.
  *
@@ -166,6 +234,8 @@ static int stm32wbxx_uart_write(const object *obj,
 	int i;
 
 #ifdef CONFIG_UART1_TX_RING_BUFF_SIZE
+	uint32_t irq;
+	int locked;
 	int ret;
 #endif
 
@@ -179,7 +249,8 @@ static int stm32wbxx_uart_write(const object *obj,
 		return -EINVAL;
 
 #ifdef CONFIG_UART1_TX_RING_BUFF_SIZE
-	HAL_NVIC_DisableIRQ(USART1_IRQn);
+	locked = stm32wbxx_uart_lock(handle);
+	irq = stm32wbxx_uart_irq_save();
 
 	for (i = 0; i < tx_len; i++) {
 		ret = ring_buffer_write(&handle->tx, buff[i]);
@@ -187,11 +258,12 @@ static int stm32wbxx_uart_write(const object *obj,
 			break;
 	}
 
-	HAL_NVIC_EnableIRQ(USART1_IRQn);
-
 	/* Enable the UART Transmit data register empty Interrupt */
 	__HAL_UART_ENABLE_IT(&handle->uart,
 			     UART_IT_TXE);
+
+	stm32wbxx_uart_irq_restore(irq);
+	stm32wbxx_uart_unlock(handle, locked);
 #else
 	if (HAL_UART_Transmit(&handle->uart, buff, tx_len,
 			      CONFIG_UART_TX_TIMEOUT) != HAL_OK)
@@ -220,6 +292,8 @@ static int stm32wbxx_uart_read(const object *obj,
 	int i;
 
 #ifdef CONFIG_UART1_RX_RING_BUFF_SIZE
+	uint32_t irq;
+	int locked;
 	int ret;
 #endif
 
@@ -233,11 +307,17 @@ static int stm32wbxx_uart_read(const object *obj,
 		return -EINVAL;
 
 #ifdef CONFIG_UART1_RX_RING_BUFF_SIZE
+	locked = stm32wbxx_uart_lock(handle);
+	irq = stm32wbxx_uart_irq_save();
+
 	for (i = 0; i < rx_len; i++) {
 		ret = ring_buffer_read(&handle->rx, &buff[i]);
 		if (ret)
 			break;
 	}
+
+	stm32wbxx_uart_irq_restore(irq);
+	stm32wbxx_uart_unlock(handle, locked);
 #else
 	if (HAL_UART_Receive(&handle->uart, buff, rx_len,
 			     CONFIG_UART_RX_TIMEOUT) != HAL_OK)
@@ -279,7 +359,7 @@ static void stm32wbxx_uart_irq_handler(stm32wbxx_uart_handle_t *handle)
 	/* UART in mode Receiver */
 	if (__HAL_UART_GET_IT_SOURCE(&handle->uart, UART_IT_RXNE)) {
 		if (__HAL_UART_GET_FLAG(&handle->uart, UART_FLAG_RXNE)) {
-			value = handle->uart.Instance->TDR;
+			value = handle->uart.Instance->RDR;
 
 			(void)ring_buffer_write(&handle->rx, value);
 		}
@@ -307,6 +387,13 @@ static uart_intf_t uart1_intf =
 
 static stm32wbxx_uart_handle_t uart1_handle;
 
+static const osMutexAttr_t uart1_mutex_attr = {
+	.name		= CONFIG_UART1_MUTEX_NAME,
+	.attr_bits	= osMutexPrioInherit,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+};
+
 static uart_config_t uart1_config =
 {
 	.baudrate	= CONFIG_UART1_HW_BAUDRATE,
@@ -406,6 +493,10 @@ static int stm32wbxx_uart1_probe(const object *obj)
 	if (ret)
 		return ret;
 
+	handle->mutex_id = osMutexNew(&uart1_mutex_attr);
+	if (!handle->mutex_id)
+		return -ENOMEM;
+
 #ifdef CONFIG_UART1_TX_RING_BUFF_SIZE
 	ret =
 		ring_buffer_init(&handle->tx,
@@ -422,6 +513,10 @@ static int stm32wbxx_uart1_probe(const object *obj)
 				 sizeof(uart1_rx_ring_buff));
 	if (ret)
 		return ret;
+
+	/* Enable the UART Receive data register not empty Interrupt */
+	__HAL_UART_ENABLE_IT(&handle->uart,
+			     UART_IT_RXNE);
 #endif
 
 	return 0;
@@ -443,6 +538,11 @@ static int stm32wbxx_uart1_shutdown(const object *obj)
 	if (HAL_UART_DeInit(&handle->uart) != HAL_OK)
 		return -EIO;
 
+	if (handle->mutex_id) {
+		(void)osMutexDelete(handle->mutex_id);
+		handle->mutex_id = NULL;
+	}
+
 	ret = clock_off(handle->clock, DRV_CLK_UART, 0);
 	if (ret)
 		return ret;
@@ -460,4 +560,8 @@ module_early_driver(CONFIG_UART1_NAME,
 		    stm32wbxx_uart1_shutdown,
 		    &uart1_intf, &uart1_handle, &uart1_config);
 
+DECLARE_OBJECT_DEPENDS(CONFIG_UART1_NAME,
+		       CONFIG_UART1_LABEL,
+		       CONFIG_CLOCK_NAME);
+
 #endif
@@ -22,6 +22,7 @@
 #include "err.h"
 #include "log.h"
 #include "version.h"
+#include "boot_profile.h"
 
 #include "stm32wbxx_hal.h"
 
@@ -88,6 +89,8 @@ void hardware_early_startup(void)
 void hardware_late_startup(void)
 {
 	hardware_print_info();
+
+	boot_profile_report();
 }
 
 /**
@@ -22,6 +22,7 @@
 #include "err.h"
 #include "log.h"
 #include "version.h"
+#include "boot_profile.h"
 
 #define TARGET_IS_TEMPEST_RC1
 #include "inc/hw_memmap.h"
@@ -68,6 +69,8 @@ void hardware_early_startup(void)
 void hardware_late_startup(void)
 {
 	hardware_print_info();
+
+	boot_profile_report();
 }
 
 typedef struct {
@@ -0,0 +1,117 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BOOT_PROFILE_H__
+#define __BOOT_PROFILE_H__
+
+#include <stdint.h>
+#include "err.h"
+#include "framework_conf.h"
+
+/**
+ * @brief	Boot profile record kinds.
+ */
+typedef enum {
+	BOOT_PROFILE_PROBE,
+	BOOT_PROFILE_SERVICE_INIT,
+	BOOT_PROFILE_THREAD_CREATE,
+	BOOT_PROFILE_QUEUE_CREATE,
+	BOOT_PROFILE_KIND_NUM
+} boot_profile_kind_t;
+
+/**
+ * @brief	Boot profile record structure definitions.
+ *
+ * @note	start_us is counted from boot_profile_start().
+ */
+typedef struct {
+	const char *	name;
+	uint32_t	kind;
+	uint32_t	start_us;
+	uint32_t	duration_us;
+} boot_profile_record_t;
+
+#if defined(CONFIG_BOOT_PROFILE_ENABLE)
+
+extern void boot_profile_start(void);
+extern uint32_t boot_profile_begin(void);
+extern void boot_profile_end(boot_profile_kind_t	kind,
+			     const char *		name,
+			     uint32_t			begin);
+extern void boot_profile_complete(void);
+extern uint32_t boot_profile_get_total_us(void);
+extern unsigned int boot_profile_get_num(void);
+extern int boot_profile_read(unsigned int		index,
+			     boot_profile_record_t *	record);
+extern void boot_profile_report(void);
+extern void boot_profile_dump(void);
+
+#else
+
+static inline void boot_profile_start(void)
+{
+}
+
+static inline uint32_t boot_profile_begin(void)
+{
+	return 0;
+}
+
+static inline void boot_profile_end(boot_profile_kind_t kind,
+				    const char *	name,
+				    uint32_t		begin)
+{
+	(void)kind;
+	(void)name;
+	(void)begin;
+}
+
+static inline void boot_profile_complete(void)
+{
+}
+
+static inline uint32_t boot_profile_get_total_us(void)
+{
+	return 0;
+}
+
+static inline unsigned int boot_profile_get_num(void)
+{
+	return 0;
+}
+
+static inline int boot_profile_read(unsigned int		index,
+				    boot_profile_record_t *	record)
+{
+	(void)index;
+	(void)record;
+
+	return -ENOSUPPORT;
+}
+
+static inline void boot_profile_report(void)
+{
+}
+
+static inline void boot_profile_dump(void)
+{
+}
+
+#endif
+
+#endif /* __BOOT_PROFILE_H__ */
@@ -53,9 +53,13 @@
 #define EPIPE       32  /* Broken pipe */
 #define EDOM        33  /* Math argument out of domain of func */
 #define ERANGE      34  /* Math result not representable */
+#define EDEADLK     35  /* Resource deadlock would occur */
 
 #define ENOSUPPORT  101 /* Not support this operation */
 #define EEMPTY      102 /* Device buffer is empty */
 #define EFULL       103 /* Device buffer is full */
 
+#define ETIMEDOUT   110 /* Operation timed out */
+#define ECANCELED   111 /* Operation canceled */
+
 #endif /* __ERR_H__ */
@@ -0,0 +1,99 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FLIGHT_RECORDER_H__
+#define __FLIGHT_RECORDER_H__
+
+#include <stdint.h>
+#include "err.h"
+#include "message.h"
+#include "framework_conf.h"
+
+/**
+ * @brief	Flight record events.
+ */
+typedef enum {
+	FLIGHT_RECORD_BOOT,
+	FLIGHT_RECORD_SEND,
+	FLIGHT_RECORD_SEND_FAIL,
+	FLIGHT_RECORD_DISPATCH
+} flight_record_event_t;
+
+/**
+ * @brief	Service index of the records without a service.
+ */
+#define FLIGHT_RECORD_NO_SERVICE 0xFF
+
+/**
+ * @brief	Flight record structure definitions.
+ *
+ * @note	src and dst are the indexes of the services in the service
+ *		section, see service_get_binding_by_index().
+ */
+typedef struct {
+	uint32_t	timestamp;      /* kernel ticks */
+	uint8_t		event;
+	uint8_t		type;
+	uint8_t		src;
+	uint8_t		dst;
+	uint32_t	id;
+	uint32_t	param0;
+	uint32_t	param1;
+} flight_record_t;
+
+#if defined(CONFIG_FLIGHT_RECORDER_ENABLE)
+
+extern void flight_recorder_record(flight_record_event_t	event,
+				   message_type_t		type,
+				   unsigned int			src,
+				   unsigned int			dst,
+				   const message_t *		message);
+extern int flight_recorder_read(unsigned int age, flight_record_t *record);
+extern void flight_recorder_dump(void);
+
+#else
+
+static inline void flight_recorder_record(flight_record_event_t event,
+					  message_type_t	type,
+					  unsigned int		src,
+					  unsigned int		dst,
+					  const message_t *	message)
+{
+	(void)event;
+	(void)type;
+	(void)src;
+	(void)dst;
+	(void)message;
+}
+
+static inline int flight_recorder_read(unsigned int age,
+				       flight_record_t *record)
+{
+	(void)age;
+	(void)record;
+
+	return -ENOSUPPORT;
+}
+
+static inline void flight_recorder_dump(void)
+{
+}
+
+#endif
+
+#endif /* __FLIGHT_RECORDER_H__ */
@@ -19,6 +19,10 @@
 #ifndef __MESSAGE_H__
 #define __MESSAGE_H__
 
+#include <stddef.h>
+#include "err.h"
+#include "framework_conf.h"
+
 /**
  * @brief	Message types definition.
  */
@@ -31,6 +35,11 @@ typedef enum {
 
 /**
  * @brief	Message structure definitions.
+ *
+ * @note	ptr may point to a block from the message payload pool.
+ *		The framework takes one reference for every queued copy of the
+ *		message and drops it after the message is dispatched, so one
+ *		payload can be shared by many receivers without copying it.
  */
 typedef struct {
 	unsigned int	id;
@@ -39,4 +48,64 @@ typedef struct {
 	void *		ptr;
 } message_t;
 
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief	Inline payload structure definitions.
+ *
+ * @note	A message sent with service_send_evt_inline() carries its
+ *		payload in the message buffer of the receiver, ptr points to
+ *		this structure in the receive buffer of the service. It is only
+ *		valid until the handler returns.
+ */
+typedef struct {
+	unsigned int	size;
+	unsigned char	data[CONFIG_SERVICE_INLINE_MAX_SIZE];
+} message_inline_t;
+#endif
+
+#if defined(CONFIG_MSG_PAYLOAD_POOL_ENABLE)
+
+extern void *message_payload_alloc(unsigned int size);
+extern int message_payload_get(const void *payload);
+extern int message_payload_put(const void *payload);
+extern int message_payload_is_valid(const void *payload);
+extern unsigned int message_payload_get_free_num(void);
+
+#else
+
+static inline void *message_payload_alloc(unsigned int size)
+{
+	(void)size;
+
+	return NULL;
+}
+
+static inline int message_payload_get(const void *payload)
+{
+	(void)payload;
+
+	return -ENOSUPPORT;
+}
+
+static inline int message_payload_put(const void *payload)
+{
+	(void)payload;
+
+	return -ENOSUPPORT;
+}
+
+static inline int message_payload_is_valid(const void *payload)
+{
+	(void)payload;
+
+	return 0;
+}
+
+static inline unsigned int message_payload_get_free_num(void)
+{
+	return 0;
+}
+
+#endif
+
 #endif /* __MESSAGE_H__ */
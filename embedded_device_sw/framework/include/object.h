@@ -32,11 +32,24 @@ typedef int (*shutdown)(const object *obj);
 typedef int (*suspend)(const object *obj, int level);
 typedef int (*resume)(const object *obj, int level);
 
+/**
+ * @brief   Object flags.
+ *
+ * OBJECT_FLAG_LAZY: the object is not probed at boot, it is probed on its
+ * first binding instead. Each binding holds a reference, which is released
+ * by object_put(), and each probed object depending on it holds one until
+ * it is shut down. If CONFIG_OBJECT_LAZY_IDLE_MS is not zero, the object is
+ * shut down once it has no reference for that long, and probed again on the
+ * next binding.
+ */
+#define OBJECT_FLAG_LAZY 0x00000001U
+
 /**
  * @brief   Standard object model structure.
  */
 typedef struct _object {
 	const char *	name;
+	unsigned int	flags;
 
 	probe		probe;                  /* Power on */
 	shutdown	shutdown;               /* Power off */
@@ -70,10 +83,12 @@ typedef struct _object {
 			intf, \
 			runtime, \
 			config, \
+			object_flags, \
 			id) \
 	static const object __object_def_ ## id ## _ ## object_label \
 	__attribute__((used, section("module_object_" #id))) = { \
 		.name		= (object_name), \
+		.flags		= (object_flags), \
 		.probe		= (probe_fn), \
 		.shutdown	= (shutdown_fn), \
 		.suspend	= (suspend_fn), \
@@ -84,16 +99,19 @@ typedef struct _object {
 
 #define module_pre(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 0)
+			intf, runtime, config, 0, 0)
 #define module_core(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 1)
+			intf, runtime, config, 0, 1)
 #define module_early_driver(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 2)
+			intf, runtime, config, 0, 2)
 #define module_driver(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 3)
+			intf, runtime, config, 0, 3)
+#define module_driver_lazy(name, label, probe, shutdown, intf, runtime, config) \
+	__define_object(name, label, probe, shutdown, NULL, NULL, \
+			intf, runtime, config, OBJECT_FLAG_LAZY, 3)
 #define module_service_manager(name, \
 			       label, \
 			       probe, \
@@ -102,18 +120,56 @@ typedef struct _object {
 			       runtime, \
 			       config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 4)
+			intf, runtime, config, 0, 4)
 #define module_service(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 5)
+			intf, runtime, config, 0, 5)
 #define module_application(name, label, probe, shutdown, intf, runtime, config) \
 	__define_object(name, label, probe, shutdown, NULL, NULL, \
-			intf, runtime, config, 6)
+			intf, runtime, config, 0, 6)
+
+/**
+ * @brief   Object dependency structure.
+ *
+ * The object is probed only after all the objects it depends on have been
+ * probed successfully, and it is canceled if one of them fails. Objects of
+ * the same level without dependencies between them may be probed
+ * concurrently.
+ */
+typedef struct {
+	const char *		name;
+	const char *const *	depends;
+	unsigned int		depends_num;
+} object_depends_t;
+
+#define __define_object_depends(object_name, object_label, ...) \
+	static const char *const __object_depends_list_ ## object_label[] = \
+	{ __VA_ARGS__ }; \
+	static const object_depends_t __object_depends_ ## object_label \
+	__attribute__((used, section("module_object_depends"))) = { \
+		.name		= (object_name), \
+		.depends	= __object_depends_list_ ## object_label, \
+		.depends_num	= \
+			sizeof(__object_depends_list_ ## object_label) / \
+			sizeof(__object_depends_list_ ## object_label[0]) }
+
+/**
+ * Declare the objects an object depends on, by name. An object may only
+ * depend on objects of its own level or of a lower level.
+ */
+#define DECLARE_OBJECT_DEPENDS(object_name, object_label, ...) \
+	__define_object_depends(object_name, object_label, __VA_ARGS__)
 
 extern int object_init(void);
 extern int object_deinit(void);
 extern int object_suspend(int level);
 extern int object_resume(int level);
 extern const object *object_get_binding(const char *const name);
+extern int object_get_id(const char *const name);
+extern const object *object_get_binding_by_id(int id);
+extern unsigned int object_hash_name(const char *name);
+extern int object_get_probe_status(const object *obj);
+extern int object_put(const object *obj);
+extern int object_get_ref_num(const object *obj);
 
 #endif /* __OBJECT_H__ */
@@ -26,11 +26,65 @@
 #include "framework_conf.h"
 #include "services_ids.h"
 #include "message.h"
+#include "mpsc_ring.h"
 #include "led_service.h"
 
+#if defined(CONFIG_SERVICE_STATIC_ENABLE) \
+	|| defined(CONFIG_SERVICE_INLINE_ENABLE)
+#include "FreeRTOS.h"
+#endif
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+#include "message_buffer.h"
+#endif
+
 struct _service_t;
 typedef struct _service_t service_t;
 
+/**
+ * @brief   Thread flags reserved by the service routine thread.
+ */
+#define SERVICE_FLAG_MESSAGE 0x00000001U
+#define SERVICE_FLAG_CALL    0x00000002U
+#define SERVICE_FLAG_READY   0x00000004U
+
+/**
+ * @brief   Service queue lanes, the urgent lane is always served first.
+ */
+typedef enum {
+	SERVICE_LANE_NORMAL,
+	SERVICE_LANE_URGENT,
+	SERVICE_LANE_NUM
+} service_lane_t;
+
+/**
+ * @brief   What a send does when the queue of the lane is full.
+ *
+ * @note    SERVICE_OVERFLOW_BLOCK waits up to CONFIG_MSG_SEND_BLOCK_TIMEOUT_MS
+ *          and fails, SERVICE_OVERFLOW_FAIL fails at once,
+ *          SERVICE_OVERFLOW_DROP_OLDEST discards the oldest queued message
+ *          to make room and SERVICE_OVERFLOW_DROP_NEWEST discards the new
+ *          message but reports success. SERVICE_OVERFLOW_DEFAULT takes the
+ *          policy of the destination service, which is blocking by default.
+ */
+typedef enum {
+	SERVICE_OVERFLOW_DEFAULT,
+	SERVICE_OVERFLOW_BLOCK,
+	SERVICE_OVERFLOW_FAIL,
+	SERVICE_OVERFLOW_DROP_OLDEST,
+	SERVICE_OVERFLOW_DROP_NEWEST,
+	SERVICE_OVERFLOW_NUM
+} service_overflow_t;
+
+/**
+ * @brief   Attributes of a send call, zero means the default of each field.
+ */
+typedef struct {
+	service_lane_t		lane;
+	service_overflow_t	overflow;
+	uint32_t		deadline;       /* absolute ticks, 0 for none */
+} service_send_attr_t;
+
 /**
  * @brief   Message structure on service definitions.
  */
@@ -38,9 +92,136 @@ typedef struct {
 	const service_t *	src;
 	const service_t *	dst;
 	message_type_t		type;
+	unsigned int		lane;
+	void *			call;
+	uint32_t		deadline;       /* absolute ticks, 0 for none */
+	unsigned int		coalesce_slot;  /* token of slot n - 1, set by the queue */
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	uint32_t		enqueue_time;   /* cycles, set by the queue */
+#endif
 	message_t		msg;
 } service_message_t;
 
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+/**
+ * @brief   Service statistics.
+ *
+ * @note    Bucket 0 of the histograms counts the times below 1us, bucket n
+ *          counts [2^(n-1), 2^n) us, the last bucket also counts all the
+ *          longer times.
+ */
+typedef struct {
+	uint32_t	handled_num;
+	uint32_t	drop_num;               /* queue full on send */
+	uint32_t	queue_high_water;       /* both lanes */
+	uint32_t	wait_max_us;
+	uint32_t	run_max_us;
+	uint32_t	wait_hist[CONFIG_SERVICE_STATS_HIST_NUM];
+	uint32_t	run_hist[CONFIG_SERVICE_STATS_HIST_NUM];
+} service_stats_t;
+#endif
+
+/**
+ * @brief   Queue disciplines of the normal lane.
+ */
+typedef enum {
+	SERVICE_DISCIPLINE_FIFO,
+	SERVICE_DISCIPLINE_EDF
+} service_discipline_t;
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+/**
+ * @brief   Entry of the earliest deadline first heap.
+ */
+typedef struct {
+	service_message_t	service_message;
+	uint32_t		seq;            /* keeps equal deadlines in order */
+} service_edf_entry_t;
+
+/**
+ * @brief   Earliest deadline first runtime of a service.
+ *
+ * The heap and the queue share the length of the normal lane, a sender
+ * takes one credit per message and the receiver gives it back when the
+ * message leaves the heap.
+ */
+typedef struct {
+	service_edf_entry_t *	entry;
+	osSemaphoreId_t		credit_id;
+	unsigned int		size;
+	unsigned int		num;
+	uint32_t		seq;
+	unsigned int		drop_late;
+	unsigned int		late_num;
+} service_edf_t;
+#endif
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief   Record of the inline queue, the payload is cut to its size.
+ */
+typedef struct {
+	message_t		msg;
+	message_inline_t	payload;
+} service_inline_record_t;
+
+/**
+ * @brief   Inline queue of a service, a message buffer of variable-length
+ *          events with the record being handled.
+ */
+typedef struct {
+	unsigned int		size;           /* bytes of the message buffer */
+	MessageBufferHandle_t	buffer;
+	unsigned int		drop_num;
+	service_inline_record_t record;
+} service_inline_queue_t;
+#endif
+
+/**
+ * @brief   Pending message of a coalescing key.
+ */
+typedef struct {
+	unsigned int	pending;
+	unsigned int	merged;         /* events replaced since the reservation */
+	message_t	msg;
+} service_coalesce_slot_t;
+
+/**
+ * @brief   Coalescing group of a service, keyed on message param0.
+ */
+typedef struct {
+	const unsigned int *	id;
+	unsigned int		id_num;
+	unsigned int		coalesced_num;
+	unsigned int		drop_num;
+	service_coalesce_slot_t slot[CONFIG_SERVICE_COALESCE_SLOT_NUM];
+} service_coalesce_t;
+
+/**
+ * @brief   Handler of one message ID.
+ */
+typedef void (*service_handler_fn_t)(const message_t *	message,
+				     message_t *	rsp_message,
+				     void *		priv);
+
+/**
+ * @brief   Dispatch table entry, an unused entry has a NULL handler.
+ */
+typedef struct {
+	unsigned int		id;
+	service_handler_fn_t	handler;
+} service_handler_t;
+
+/**
+ * @brief   Dispatch table of one message group, see MSG_ID_GET_GROUP().
+ *
+ * @note    The entries are indexed by MSG_ID_GET_INDEX() of their ID.
+ */
+typedef struct {
+	const service_handler_t *	entry;
+	unsigned int			entry_num;
+} service_handler_table_t;
+
 /**
  * @brief   Service handle definitions.
  */
@@ -49,11 +230,36 @@ typedef struct _service_t {
 	const char *		name;
 	osThreadId_t		thread_id;
 	osMessageQueueId_t	queue_id;
+	osMessageQueueId_t	urgent_queue_id;
 	int (*init)(const service_t *svc, void *priv);
 	int (*deinit)(const service_t *svc, void *priv);
 	void (*handle_message)(const message_t *message, message_t *rsp_message,
 			       void *priv);
+	void (*handle_messages)(const message_t *message,
+				message_t *rsp_message, unsigned int num,
+				void *priv);
+	void (*on_idle)(void *priv);
+	const service_handler_table_t *dispatch;
+	unsigned int		dispatch_num;
 	void *			priv;
+	const unsigned int *	subscription;
+	unsigned int		subscription_num;
+	unsigned int		broadcast_drop_num;
+	service_overflow_t	overflow;
+	unsigned int		overflow_num[SERVICE_OVERFLOW_NUM];
+	mpsc_ring_t *		isr_ring;
+	service_coalesce_t *	coalesce;
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	service_inline_queue_t *inline_queue;
+#endif
+	unsigned int		scheduled;
+	unsigned int		ready;
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	service_stats_t		stats;
+#endif
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	service_edf_t		edf;
+#endif
 } service_t;
 
 /**
@@ -62,6 +268,14 @@ typedef struct _service_t {
 typedef struct {
 	osThreadAttr_t		thread_attr;
 	osMessageQueueAttr_t	queue_attr;
+	osMessageQueueAttr_t	urgent_queue_attr;
+	uint32_t		queue_length;           /* 0 for the default */
+	service_discipline_t	discipline;
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	service_edf_entry_t *	edf_mem;
+	uint32_t		edf_size;
+	uint32_t		edf_drop_late;          /* drop the late messages */
+#endif
 } service_config_t;
 
 /**
@@ -71,37 +285,213 @@ typedef struct {
 	int (*init)(const object *obj, const service_config_t *config);
 	int (*deinit)(const object *obj);
 	int (*send_message)(const object *		obj,
-			    const service_message_t *	service_message);
+			    const service_message_t *	service_message,
+			    service_overflow_t		overflow);
 	void (*handle_message)(const object *		obj,
 			       const service_message_t *service_message);
+	void (*handle_messages)(const object *			obj,
+				const service_message_t *	service_message,
+				unsigned int			num);
 } service_intf_t;
 
 extern const service_config_t service_config_default;
 extern const service_intf_t service_intf_default;
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+extern const service_config_t service_config_actor;
+extern const service_intf_t service_intf_actor;
+#endif
 
 extern int service_probe(const object *obj);
 extern int service_shutdown(const object *obj);
 extern const service_t *service_get_binding(const char *const name);
+extern const service_t *service_get_binding_by_id(int id);
+extern const service_t *service_get_binding_by_index(unsigned int index);
 extern const object *service_get_owner(const service_t *svc);
 extern const char *service_get_name(const service_t *svc);
 extern osThreadId_t service_get_thread_id(const service_t *svc);
 extern osMessageQueueId_t service_get_queue_id(const service_t *svc);
+extern int service_get_lane_depth(const service_t *svc, service_lane_t lane);
+extern int service_queue_space(const service_t *svc, service_lane_t lane);
+extern unsigned int service_get_overflow_num(const service_t *	svc,
+					     service_overflow_t		overflow);
 extern void *service_get_private_data(const service_t *svc);
 extern int service_send_evt(const service_t *dst, const message_t *message);
+extern int service_send_evt_attr(const service_t *		dst,
+				 const message_t *		message,
+				 const service_send_attr_t *	attr);
 extern int service_send_req(const service_t *	dst,
 			    const service_t *	src,
 			    const message_t *	message);
+extern int service_send_req_attr(const service_t *		dst,
+				 const service_t *		src,
+				 const message_t *		message,
+				 const service_send_attr_t *	attr);
 extern int service_send_rsp(const service_t *	dst,
 			    const service_t *	src,
 			    const message_t *	message);
+extern int service_call(const service_t *	dst,
+			const message_t *	message,
+			message_t *		rsp_message,
+			uint32_t		timeout);
 extern int service_broadcast_evt(const message_t *message);
+extern int service_wait_ready(unsigned int timeout_ms);
+extern int service_is_handled(const service_t *svc, unsigned int id);
+extern int service_send_evt_from_isr(const service_t *	dst,
+				     const message_t *	message);
+extern unsigned int service_get_isr_drop_num(const service_t *svc);
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+extern int service_send_evt_inline(const service_t *	dst,
+				   const message_t *	message,
+				   const void *		data,
+				   unsigned int		size);
+extern unsigned int service_get_inline_drop_num(const service_t *svc);
+#endif
+extern unsigned int service_get_broadcast_drop_num(const service_t *svc);
+extern unsigned int service_get_coalesce_num(const service_t *svc);
+extern unsigned int service_get_coalesce_drop_num(const service_t *svc);
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+extern unsigned int service_get_late_num(const service_t *svc);
+#endif
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+extern int service_get_stats(const service_t *svc, service_stats_t *stats);
+extern void service_clear_stats(const service_t *svc);
+extern void service_dump_stats(void);
+#endif
+
+/**
+ * @brief   Subscribe the service to the broadcast message IDs.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(), for example
+ *          DECLARE_SERVICE(..., handle_fn, SERVICE_SUBSCRIBE(MSG_ID_A, MSG_ID_B)).
+ *          A service without subscription receives all broadcast messages.
+ */
+#define SERVICE_SUBSCRIBE(...) \
+	.subscription = (const unsigned int[]){ __VA_ARGS__ }, \
+	.subscription_num = \
+		sizeof((const unsigned int[]){ __VA_ARGS__ }) / sizeof(unsigned int)
+
+/**
+ * @brief   The service does not receive any broadcast message.
+ */
+#define SERVICE_SUBSCRIBE_NONE \
+	.subscription = (const unsigned int[]){ 0 }, \
+	.subscription_num = 0
+
+/**
+ * @brief   Handle the messages in batches.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(). Up to
+ *          CONFIG_SERVICE_BATCH_MAX_NUM queued messages are drained on each
+ *          wakeup and passed to the handler in one call, it replaces
+ *          handle_message. rsp_message[i] is the response of message[i].
+ */
+#define SERVICE_BATCH_HANDLER(handle_messages_fn) \
+	.handle_messages = (handle_messages_fn)
+
+/**
+ * @brief   Dispatch the messages through handler tables.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(), with one
+ *          SERVICE_HANDLER_TABLE() for each message group the service
+ *          handles. A message is passed to the handler of its ID in O(1),
+ *          the others go to handle_message. If handle_message is NULL, the
+ *          IDs without a handler are refused by the send with -ENOSUPPORT
+ *          and are not broadcast to the service.
+ */
+#define SERVICE_DISPATCH(...) \
+	.dispatch = (const service_handler_table_t[]){ __VA_ARGS__ }, \
+	.dispatch_num = \
+		sizeof((const service_handler_table_t[]){ __VA_ARGS__ }) / \
+		sizeof(service_handler_table_t)
+
+/**
+ * @brief   Handler table of the message IDs of one group.
+ *
+ * @note    The table is sized by the highest index of the IDs, so the IDs of
+ *          a group should be numbered from 1 without large gaps.
+ */
+#define SERVICE_HANDLER_TABLE(...) \
+	{ \
+		.entry = (const service_handler_t[]){ __VA_ARGS__ }, \
+		.entry_num = sizeof((const service_handler_t[]){ __VA_ARGS__ }) / \
+			     sizeof(service_handler_t), \
+	}
+
+/**
+ * @brief   Handle the message ID with the function.
+ */
+#define SERVICE_HANDLER(msg_id, handler_fn) \
+	[MSG_ID_GET_INDEX(msg_id)] = { \
+		.id = (msg_id), \
+		.handler = (handler_fn), \
+	}
+
+/**
+ * @brief   Accept events from interrupt handlers.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(). length is the
+ *          number of events in the lock-free ring, must be a power of two.
+ */
+#define SERVICE_ISR_RING(length) \
+	.isr_ring = &(mpsc_ring_t)MPSC_RING_INITIALIZER(length, \
+							sizeof(message_t))
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief   Accept events with an inline payload.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(). size is the number
+ *          of bytes of the message buffer, each event takes its payload size
+ *          plus a header of sizeof(message_t) + 8 bytes. The events are
+ *          served after the normal lane, one per wakeup.
+ */
+#define SERVICE_INLINE_QUEUE(queue_size) \
+	.inline_queue = &(service_inline_queue_t){ \
+		.size = (queue_size), \
+	}
+#endif
+
+/**
+ * @brief   Coalesce the pending events of the group, the last writer wins.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(). An event with one
+ *          of the IDs replaces in place the pending event of the group with
+ *          the same param0, instead of being queued again. Only the events
+ *          on the normal lane without a pool payload are coalesced. Up to
+ *          CONFIG_SERVICE_COALESCE_SLOT_NUM keys can be pending, the others
+ *          are queued as usual.
+ */
+#define SERVICE_COALESCE(...) \
+	.coalesce = &(service_coalesce_t){ \
+		.id = (const unsigned int[]){ __VA_ARGS__ }, \
+		.id_num = sizeof((const unsigned int[]){ __VA_ARGS__ }) / \
+			  sizeof(unsigned int), \
+	}
+
+/**
+ * @brief   Set the overflow policy of the service.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE(), it applies to the
+ *          sends made with SERVICE_OVERFLOW_DEFAULT.
+ */
+#define SERVICE_OVERFLOW(policy) \
+	.overflow = (policy)
+
+/**
+ * @brief   Called once the message queue is empty, for flushing the output.
+ *
+ * @note    Used as the optional tail of DECLARE_SERVICE().
+ */
+#define SERVICE_IDLE_HANDLER(on_idle_fn) \
+	.on_idle = (on_idle_fn)
 
 #define DECLARE_SERVICE(service_name, \
 			service_label, \
 			priv_data, \
 			init_fn, \
 			deinit_fn, \
-			handle_message_fn) \
+			handle_message_fn, \
+			...) \
 	__define_service(service_name, \
 			 service_label, \
 			 priv_data, \
@@ -109,7 +499,158 @@ extern int service_broadcast_evt(const message_t *message);
 			 &service_config_default, \
 			 init_fn, \
 			 deinit_fn, \
-			 handle_message_fn)
+			 handle_message_fn, \
+			 ## __VA_ARGS__)
+
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+/**
+ * @brief   Declare a run-to-completion actor service.
+ *
+ * @note    The actor has no thread, its messages are handled by the shared
+ *          worker pool, one message or batch at a time. The handlers must
+ *          not block for long. Interrupt events are not supported.
+ */
+#define DECLARE_ACTOR_SERVICE(service_name, \
+			      service_label, \
+			      priv_data, \
+			      init_fn, \
+			      deinit_fn, \
+			      handle_message_fn, \
+			      ...) \
+	__define_service(service_name, \
+			 service_label, \
+			 priv_data, \
+			 &service_intf_actor, \
+			 &service_config_actor, \
+			 init_fn, \
+			 deinit_fn, \
+			 handle_message_fn, \
+			 ## __VA_ARGS__)
+#endif
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+/**
+ * @brief   Declare a service dispatching the earliest deadline first.
+ *
+ * @note    The normal lane is served by the deadline of the messages, see
+ *          service_send_attr_t, the messages without a deadline come last
+ *          in their arrival order. If drop_late is set, the messages found
+ *          past their deadline are dropped instead of being handled, a
+ *          dropped service_call() fails with -EPIPE. The urgent lane and the
+ *          interrupt events are still served first. The deadline heap holds
+ *          as many messages as the queue, both count in the normal lane.
+ */
+#define DECLARE_EDF_SERVICE(service_name, \
+			    service_label, \
+			    priv_data, \
+			    init_fn, \
+			    deinit_fn, \
+			    handle_message_fn, \
+			    thread_queue_length, \
+			    drop_late, \
+			    ...) \
+	static service_edf_entry_t __service_edf_mem_ ## service_label \
+	[thread_queue_length]; \
+	static const service_config_t __service_config_ ## service_label = { \
+		.thread_attr		= { \
+			.name		= (service_name), \
+			.attr_bits	= osThreadDetached, \
+			.stack_size	= CONFIG_SERVICE_DEFAULT_THREAD_STACK_SIZE, \
+			.priority	= CONFIG_SERVICE_DEFAULT_THREAD_PRIORITY, \
+		}, \
+		.queue_attr		= { \
+			.name		= CONFIG_SERVICE_DEFAULT_QUEUE_NAME, \
+		}, \
+		.urgent_queue_attr	= { \
+			.name		= CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_NAME, \
+		}, \
+		.queue_length		= (thread_queue_length), \
+		.discipline		= SERVICE_DISCIPLINE_EDF, \
+		.edf_mem		= __service_edf_mem_ ## service_label, \
+		.edf_size		= (thread_queue_length), \
+		.edf_drop_late		= (drop_late), \
+	}; \
+	__define_service(service_name, \
+			 service_label, \
+			 priv_data, \
+			 &service_intf_default, \
+			 &__service_config_ ## service_label, \
+			 init_fn, \
+			 deinit_fn, \
+			 handle_message_fn, \
+			 ## __VA_ARGS__)
+#endif
+
+#if defined(CONFIG_SERVICE_STATIC_ENABLE)
+/**
+ * @brief   Declare a service with statically allocated thread and queues.
+ *
+ * @note    The control blocks, the stack and the queue storage are sized
+ *          for this service and reserved at link time, nothing is taken
+ *          from the heap when the service is probed.
+ */
+#define DECLARE_STATIC_SERVICE(service_name, \
+			       service_label, \
+			       priv_data, \
+			       init_fn, \
+			       deinit_fn, \
+			       handle_message_fn, \
+			       thread_stack_size, \
+			       thread_queue_length, \
+			       ...) \
+	static StaticTask_t __service_thread_cb_ ## service_label; \
+	static uint64_t __service_thread_stack_ ## service_label \
+	[((thread_stack_size) + 7) / 8]; \
+	static StaticQueue_t __service_queue_cb_ ## service_label; \
+	static uint32_t __service_queue_mem_ ## service_label \
+	[(thread_queue_length) * sizeof(service_message_t) / 4]; \
+	static StaticQueue_t __service_urgent_queue_cb_ ## service_label; \
+	static uint32_t __service_urgent_queue_mem_ ## service_label \
+	[CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_LENGTH * \
+	 sizeof(service_message_t) / 4]; \
+	static const service_config_t __service_config_ ## service_label = { \
+		.thread_attr		= { \
+			.name		= (service_name), \
+			.attr_bits	= osThreadDetached, \
+			.cb_mem		= &__service_thread_cb_ ## service_label, \
+			.cb_size	= sizeof(StaticTask_t), \
+			.stack_mem	= __service_thread_stack_ ## service_label, \
+			.stack_size	= \
+				sizeof(__service_thread_stack_ ## service_label), \
+			.priority	= CONFIG_SERVICE_DEFAULT_THREAD_PRIORITY, \
+		}, \
+		.queue_attr		= { \
+			.name		= CONFIG_SERVICE_DEFAULT_QUEUE_NAME, \
+			.attr_bits	= 0, \
+			.cb_mem		= &__service_queue_cb_ ## service_label, \
+			.cb_size	= sizeof(StaticQueue_t), \
+			.mq_mem		= __service_queue_mem_ ## service_label, \
+			.mq_size	= \
+				sizeof(__service_queue_mem_ ## service_label), \
+		}, \
+		.urgent_queue_attr	= { \
+			.name		= CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_NAME, \
+			.attr_bits	= 0, \
+			.cb_mem		= \
+				&__service_urgent_queue_cb_ ## service_label, \
+			.cb_size	= sizeof(StaticQueue_t), \
+			.mq_mem		= \
+				__service_urgent_queue_mem_ ## service_label, \
+			.mq_size	= \
+				sizeof(__service_urgent_queue_mem_ ## service_label), \
+		}, \
+		.queue_length		= (thread_queue_length), \
+	}; \
+	__define_service(service_name, \
+			 service_label, \
+			 priv_data, \
+			 &service_intf_default, \
+			 &__service_config_ ## service_label, \
+			 init_fn, \
+			 deinit_fn, \
+			 handle_message_fn, \
+			 ## __VA_ARGS__)
+#endif
 
 #define __define_service(service_name, \
 			 service_label, \
@@ -118,17 +659,20 @@ extern int service_broadcast_evt(const message_t *message);
 			 config, \
 			 init_fn, \
 			 deinit_fn, \
-			 handle_message_fn) \
+			 handle_message_fn, \
+			 ...) \
 	static service_t __service_def_ ## service_label \
 	__attribute__((used, section("module_service"))) = { \
 		.owner		= NULL, \
 		.name		= (service_name), \
 		.thread_id	= NULL, \
 		.queue_id	= NULL, \
+		.urgent_queue_id = NULL, \
 		.init		= (init_fn), \
 		.deinit		= (deinit_fn), \
 		.handle_message = (handle_message_fn), \
-		.priv		= (priv_data) }; \
+		.priv		= (priv_data), \
+		## __VA_ARGS__ }; \
 	module_service(service_name, \
 		       service_label, \
 		       service_probe, \
@@ -0,0 +1,68 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVICE_BRIDGE_H__
+#define __SERVICE_BRIDGE_H__
+
+#include "message.h"
+#include "service.h"
+#include "service_transport.h"
+#include "framework_conf.h"
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE) \
+	&& defined(CONFIG_SERVICE_BRIDGE_ENABLE)
+
+#define SERVICE_BRIDGE_SYNC_0	0xA5
+#define SERVICE_BRIDGE_SYNC_1	0x5A
+
+/**
+ * @brief   Service bridge frame definitions.
+ *
+ * @note    All the fields are little endian. The CRC is computed by the CRC
+ *          driver on the words before it, so a frame can be told apart from
+ *          the text traces sharing the port. seq counts the frames sent by
+ *          each side, a gap means the peer lost frames.
+ */
+typedef struct {
+	unsigned char	sync[2];
+	unsigned char	seq;
+	unsigned char	type;
+	unsigned int	dst_hash;
+	unsigned int	src_hash;
+	unsigned int	id;
+	unsigned int	param0;
+	unsigned int	param1;
+	unsigned int	crc;
+} service_bridge_frame_t;
+
+#define SERVICE_BRIDGE_CRC_WORDS \
+	((sizeof(service_bridge_frame_t) - sizeof(unsigned int)) / 4)
+
+extern int service_bridge_encode(service_bridge_frame_t *	frame,
+				 unsigned int			dst_hash,
+				 unsigned int			src_hash,
+				 message_type_t			type,
+				 const message_t *		message);
+extern int service_bridge_decode(const service_bridge_frame_t *frame);
+extern unsigned int service_bridge_get_tx_num(void);
+extern unsigned int service_bridge_get_rx_num(void);
+extern unsigned int service_bridge_get_error_num(void);
+
+#endif
+
+#endif /* __SERVICE_BRIDGE_H__ */
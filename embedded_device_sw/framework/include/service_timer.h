@@ -0,0 +1,110 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVICE_TIMER_H__
+#define __SERVICE_TIMER_H__
+
+#include <stdint.h>
+#include "err.h"
+#include "message.h"
+#include "framework_conf.h"
+
+struct _service_t;
+
+/**
+ * @brief	Service timer structure definitions.
+ *
+ * @note	The storage is owned by the caller, usually it is embedded in
+ *		the private data of the service. Nothing is allocated when the
+ *		timer is started, so the number of timers is not limited.
+ *		The storage must be zeroed before the first start, the fields
+ *		are private to the timer wheel. An expiry refused by a full
+ *		queue is sent again on the next tick, until the timer is
+ *		stopped or started again.
+ */
+typedef struct service_timer {
+	struct service_timer *		next;
+	struct service_timer **		pprev;
+	uint32_t			expiry;
+	uint8_t				level;
+	uint8_t				slot;
+	uint8_t				active;
+	uint8_t				gen;    /* bumped by start and stop */
+	const struct _service_t *	svc;
+	message_t			msg;
+} service_timer_t;
+
+#if defined(CONFIG_SERVICE_TIMER_ENABLE)
+
+extern int service_timer_start(service_timer_t *		timer,
+			       const struct _service_t *	svc,
+			       unsigned int			ms,
+			       const message_t *		msg);
+extern int service_timer_stop(service_timer_t *timer);
+extern int service_timer_is_active(const service_timer_t *timer);
+extern unsigned int service_timer_get_active_num(void);
+extern unsigned int service_timer_get_drop_num(void);
+extern unsigned int service_timer_get_retry_num(void);
+
+#else
+
+static inline int service_timer_start(service_timer_t *		timer,
+				      const struct _service_t *	svc,
+				      unsigned int			ms,
+				      const message_t *		msg)
+{
+	(void)timer;
+	(void)svc;
+	(void)ms;
+	(void)msg;
+
+	return -ENOSUPPORT;
+}
+
+static inline int service_timer_stop(service_timer_t *timer)
+{
+	(void)timer;
+
+	return -ENOSUPPORT;
+}
+
+static inline int service_timer_is_active(const service_timer_t *timer)
+{
+	(void)timer;
+
+	return 0;
+}
+
+static inline unsigned int service_timer_get_active_num(void)
+{
+	return 0;
+}
+
+static inline unsigned int service_timer_get_drop_num(void)
+{
+	return 0;
+}
+
+static inline unsigned int service_timer_get_retry_num(void)
+{
+	return 0;
+}
+
+#endif
+
+#endif /* __SERVICE_TIMER_H__ */
@@ -0,0 +1,131 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SERVICE_TRANSPORT_H__
+#define __SERVICE_TRANSPORT_H__
+
+#include "object.h"
+#include "err.h"
+#include "message.h"
+#include "service.h"
+#include "framework_conf.h"
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE)
+
+/**
+ * @brief   Service transport interface definitions.
+ *
+ * @note    A transport carries service messages to the services of a peer.
+ *          The services on both sides are named by object_hash_name() of
+ *          their name, src_hash is 0 for a message without source. Only
+ *          id, param0 and param1 of the message are carried.
+ */
+typedef struct {
+	int (*send)(const object *	obj,
+		    unsigned int	dst_hash,
+		    unsigned int	src_hash,
+		    message_type_t	type,
+		    const message_t *	message);
+} service_transport_intf_t;
+
+/**
+ * @brief   Remote service structure definitions.
+ */
+typedef struct {
+	const char *	remote_name;
+	const char *	transport_name;
+	const object *	transport;
+	unsigned int	remote_hash;
+	unsigned int	send_num;
+	unsigned int	drop_num;
+} service_remote_t;
+
+extern const service_intf_t service_intf_remote;
+
+extern int service_transport_deliver(const object *	transport,
+				     unsigned int	dst_hash,
+				     unsigned int	src_hash,
+				     message_type_t	type,
+				     const message_t *	message);
+extern int service_is_remote(const service_t *svc);
+extern unsigned int service_remote_get_send_num(const service_t *svc);
+extern unsigned int service_remote_get_drop_num(const service_t *svc);
+
+/**
+ * @brief   Send a message to the service of a peer through the transport.
+ *
+ * @param   obj Pointer to the transport object handle.
+ * @param   dst_hash Name hash of the destination service of the peer.
+ * @param   src_hash Name hash of the source service, 0 for none.
+ * @param   type Message type.
+ * @param   message Message structure to send.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int service_transport_send(const object *		obj,
+					 unsigned int		dst_hash,
+					 unsigned int		src_hash,
+					 message_type_t		type,
+					 const message_t *	message)
+{
+	service_transport_intf_t *intf;
+
+	if (!obj)
+		return -EINVAL;
+
+	intf = (service_transport_intf_t *)obj->object_intf;
+	if ((intf == NULL)
+	    || (intf->send == NULL))
+		return -ENOSUPPORT;
+
+	return intf->send(obj, dst_hash, src_hash, type, message);
+}
+
+/**
+ * @brief   Declare a local proxy of a service of the peer.
+ *
+ * @note    The sends to the proxy are passed to the transport, so a remote
+ *          service is used like a local one. The proxy has no thread and no
+ *          queue, service_call() and message->ptr are not supported. Like
+ *          any service, a proxy without SERVICE_SUBSCRIBE() gets all the
+ *          broadcasts and forwards them to the peer. The requests of the
+ *          peer can only be answered if the peer service which sent them
+ *          has a proxy on the same transport.
+ */
+#define DECLARE_REMOTE_SERVICE(service_name, \
+			       service_label, \
+			       remote_service_name, \
+			       transport_object_name, \
+			       ...) \
+	static service_remote_t __service_remote_ ## service_label = { \
+		.remote_name	= (remote_service_name), \
+		.transport_name = (transport_object_name), \
+	}; \
+	__define_service(service_name, \
+			 service_label, \
+			 &__service_remote_ ## service_label, \
+			 &service_intf_remote, \
+			 NULL, \
+			 NULL, \
+			 NULL, \
+			 NULL, \
+			 ## __VA_ARGS__)
+
+#endif
+
+#endif /* __SERVICE_TRANSPORT_H__ */
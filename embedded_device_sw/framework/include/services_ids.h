@@ -32,6 +32,16 @@
 #define MSG_ID_TUNIT_SERVICE_BASE       0x00F00000
 #define MSG_ID_SYS_SERVICE_BASE         0x00FF0000
 
+/**
+ * @brief   Split a message ID into its group, the type and the service base,
+ *          and its index in the group.
+ */
+#define MSG_ID_GROUP_MASK               0xFFFF0000
+#define MSG_ID_INDEX_MASK               0x0000FFFF
+
+#define MSG_ID_GET_GROUP(id)            ((id) & MSG_ID_GROUP_MASK)
+#define MSG_ID_GET_INDEX(id)            ((id) & MSG_ID_INDEX_MASK)
+
 /** Message ID for LED service */
 
 /**
@@ -67,6 +77,17 @@
 #define MSG_ID_LED_PATTERN_COMPLETED (MSG_TYPE_EVT_BASE | \
 				      MSG_ID_LED_SERVICE_BASE | 0x0003)
 
+/**
+ * @brief           LED cycle timer expired, internal to the LED service.
+ *
+ * @message.id      MSG_ID_LED_TIMER_EXPIRED
+ * @message.param0  LED ID.
+ * @message.param1  Generation of the pattern the timer was started for.
+ * @message.ptr     None.
+ */
+#define MSG_ID_LED_TIMER_EXPIRED (MSG_TYPE_EVT_BASE | \
+				  MSG_ID_LED_SERVICE_BASE | 0x0004)
+
 /** Message ID for system service */
 
 /**
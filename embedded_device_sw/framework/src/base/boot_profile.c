@@ -0,0 +1,296 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "cmsis_compiler.h"
+#include "err.h"
+#include "cycle_counter.h"
+#include "boot_profile.h"
+
+#if defined(CONFIG_BOOT_PROFILE_ENABLE)
+
+#if (CONFIG_BOOT_PROFILE_RECORD_NUM > 256)
+#error "CONFIG_BOOT_PROFILE_RECORD_NUM must not be more than 256."
+#endif
+
+/**
+ * @brief	Boot profile definitions.
+ *
+ * @note	The cycle counter wraps after 2^32 cycles, which is more than
+ *		a minute at the clock rates of the supported products.
+ */
+typedef struct {
+	uint32_t		base;
+	uint32_t		cycles_per_us;
+	uint32_t		total_us;
+	volatile uint32_t	num;
+	int			started;
+	boot_profile_record_t	record[CONFIG_BOOT_PROFILE_RECORD_NUM];
+} boot_profile_t;
+
+static boot_profile_t boot_profile;
+
+static const char *const boot_profile_kind_name[BOOT_PROFILE_KIND_NUM] = {
+	[BOOT_PROFILE_PROBE]		= "probe",
+	[BOOT_PROFILE_SERVICE_INIT]	= "init",
+	[BOOT_PROFILE_THREAD_CREATE]	= "thread",
+	[BOOT_PROFILE_QUEUE_CREATE]	= "queue",
+};
+
+/**
+ * @brief	Convert cycles to microseconds.
+ *
+ * @param	cycles Number of cycles.
+ *
+ * @retval	Returns the number of microseconds.
+ */
+static uint32_t boot_profile_us(uint32_t cycles)
+{
+	return cycles / boot_profile.cycles_per_us;
+}
+
+/**
+ * @brief	Start the cycle counter, the boot is timed from here.
+ *
+ * @param	None.
+ *
+ * @retval	None.
+ *
+ * @note	Called before the kernel starts, once the system clock is set.
+ */
+void boot_profile_start(void)
+{
+	boot_profile_t *profile = &boot_profile;
+
+	cycle_counter_start();
+
+	profile->cycles_per_us = osKernelGetSysTimerFreq() / 1000000;
+	if (!profile->cycles_per_us)
+		profile->cycles_per_us = 1;
+
+	profile->num = 0;
+	profile->total_us = 0;
+	profile->base = cycle_counter_read();
+	profile->started = 1;
+}
+
+/**
+ * @brief	Get the timestamp of the beginning of a step.
+ *
+ * @param	None.
+ *
+ * @retval	Returns the timestamp to pass to boot_profile_end().
+ */
+uint32_t boot_profile_begin(void)
+{
+	return cycle_counter_read();
+}
+
+/**
+ * @brief	Record a step, it can be called from any thread.
+ *
+ * @param	kind The step kind.
+ * @param	name The object name, it must stay valid.
+ * @param	begin Timestamp returned by boot_profile_begin().
+ *
+ * @retval	None.
+ *
+ * @note	The steps after the table is full are not recorded.
+ */
+void boot_profile_end(boot_profile_kind_t	kind,
+		      const char *		name,
+		      uint32_t			begin)
+{
+	boot_profile_t *profile = &boot_profile;
+	uint32_t end = cycle_counter_read();
+	boot_profile_record_t *record;
+	uint32_t pos;
+
+	if (!profile->started)
+		return;
+
+	do {
+		pos = __LDREXW(&profile->num);
+		if (pos >= CONFIG_BOOT_PROFILE_RECORD_NUM) {
+			__CLREX();
+			return;
+		}
+	} while (__STREXW(pos + 1, &profile->num));
+
+	record = &profile->record[pos];
+	record->name = name ? name : "?";
+	record->kind = kind;
+	record->start_us = boot_profile_us(begin - profile->base);
+	record->duration_us = boot_profile_us(end - begin);
+}
+
+/**
+ * @brief	Mark the boot completed, when the startup event is broadcast.
+ *
+ * @param	None.
+ *
+ * @retval	None.
+ */
+void boot_profile_complete(void)
+{
+	boot_profile_t *profile = &boot_profile;
+
+	if (!profile->started)
+		return;
+
+	profile->total_us =
+		boot_profile_us(cycle_counter_read() - profile->base);
+
+	printf("boot completed in %u us\r\n", (unsigned int)profile->total_us);
+}
+
+/**
+ * @brief	Get the time to the startup completed event.
+ *
+ * @param	None.
+ *
+ * @retval	Returns the time in microseconds, 0 if the boot is not done.
+ */
+uint32_t boot_profile_get_total_us(void)
+{
+	return boot_profile.total_us;
+}
+
+/**
+ * @brief	Get the number of records.
+ *
+ * @param	None.
+ *
+ * @retval	Returns the number of records.
+ */
+unsigned int boot_profile_get_num(void)
+{
+	uint32_t num = boot_profile.num;
+
+	return num < CONFIG_BOOT_PROFILE_RECORD_NUM ?
+	       num : CONFIG_BOOT_PROFILE_RECORD_NUM;
+}
+
+/**
+ * @brief	Read a record, in recording order.
+ *
+ * @param	index Index of the record.
+ * @param	record Pointer to the record copy.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int boot_profile_read(unsigned int index, boot_profile_record_t *record)
+{
+	if (!record)
+		return -EINVAL;
+
+	if (index >= boot_profile_get_num())
+		return -ENOENT;
+
+	*record = boot_profile.record[index];
+
+	return 0;
+}
+
+/**
+ * @brief	Print the records, the slowest first.
+ *
+ * @param	None.
+ *
+ * @retval	None.
+ */
+void boot_profile_report(void)
+{
+	boot_profile_t *profile = &boot_profile;
+	uint8_t order[CONFIG_BOOT_PROFILE_RECORD_NUM];
+	const boot_profile_record_t *record;
+	unsigned int num = boot_profile_get_num();
+	unsigned int i;
+	unsigned int j;
+	uint8_t tmp;
+
+	for (i = 0; i < num; i++) {
+		order[i] = i;
+
+		/* Insertion sort, the table is small */
+		for (j = i; j > 0; j--) {
+			if (profile->record[order[j - 1]].duration_us >=
+			    profile->record[order[j]].duration_us)
+				break;
+
+			tmp = order[j - 1];
+			order[j - 1] = order[j];
+			order[j] = tmp;
+		}
+	}
+
+	printf("boot report, %u steps, now %u us:\r\n",
+	       num,
+	       (unsigned int)boot_profile_us(cycle_counter_read() -
+					     profile->base));
+
+	for (i = 0; i < num; i++) {
+		record = &profile->record[order[i]];
+
+		printf("%10u us %-6s at %10u us <%s>\r\n",
+		       (unsigned int)record->duration_us,
+		       record->kind < BOOT_PROFILE_KIND_NUM ?
+		       boot_profile_kind_name[record->kind] : "?",
+		       (unsigned int)record->start_us,
+		       record->name);
+	}
+
+	if (profile->total_us)
+		printf("boot completed in %u us\r\n",
+		       (unsigned int)profile->total_us);
+}
+
+/**
+ * @brief	Print the records in a machine readable form.
+ *
+ * @param	None.
+ *
+ * @retval	None.
+ *
+ * @note	One "boot,<kind>,<name>,<start_us>,<duration_us>" line per
+ *		record in recording order, then "boot,total,,0,<total_us>".
+ */
+void boot_profile_dump(void)
+{
+	boot_profile_t *profile = &boot_profile;
+	const boot_profile_record_t *record;
+	unsigned int num = boot_profile_get_num();
+	unsigned int i;
+
+	for (i = 0; i < num; i++) {
+		record = &profile->record[i];
+
+		printf("boot,%s,%s,%u,%u\r\n",
+		       record->kind < BOOT_PROFILE_KIND_NUM ?
+		       boot_profile_kind_name[record->kind] : "?",
+		       record->name,
+		       (unsigned int)record->start_us,
+		       (unsigned int)record->duration_us);
+	}
+
+	printf("boot,total,,0,%u\r\n", (unsigned int)profile->total_us);
+}
+
+#endif
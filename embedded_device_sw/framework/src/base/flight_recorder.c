@@ -0,0 +1,270 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "cmsis_os2.h"
+#include "cmsis_compiler.h"
+#include "object.h"
+#include "err.h"
+#include "log.h"
+#include "message.h"
+#include "service.h"
+#include "flight_recorder.h"
+
+#if defined(CONFIG_FLIGHT_RECORDER_ENABLE)
+
+#if (CONFIG_FLIGHT_RECORDER_RECORD_NUM & (CONFIG_FLIGHT_RECORDER_RECORD_NUM - 1))
+#error "CONFIG_FLIGHT_RECORDER_RECORD_NUM must be a power of two."
+#endif
+
+/**
+ * @brief	The recorder is kept over a warm reset, the linker must place
+ *		the section in an UNINIT region.
+ */
+#if defined(__CC_ARM)
+#define FLIGHT_RECORDER_NOINIT \
+	__attribute__((section(".bss.noinit"), zero_init))
+#else
+#define FLIGHT_RECORDER_NOINIT __attribute__((section(".noinit")))
+#endif
+
+#define FLIGHT_RECORDER_MAGIC 0x46524543
+
+/**
+ * @brief	Flight recorder definitions.
+ */
+typedef struct {
+	uint32_t		magic;
+	volatile uint32_t	head;
+	flight_record_t		record[CONFIG_FLIGHT_RECORDER_RECORD_NUM];
+} flight_recorder_t;
+
+static flight_recorder_t flight_recorder FLIGHT_RECORDER_NOINIT;
+
+/* Cleared on every boot, nothing is recorded before the probe */
+static volatile int flight_recorder_ready;
+
+/**
+ * @brief	Claim the position of a new record.
+ *
+ * @param	recorder Pointer to the recorder.
+ *
+ * @retval	Returns the claimed position.
+ */
+static uint32_t flight_recorder_claim(flight_recorder_t *recorder)
+{
+	uint32_t pos;
+
+	do
+		pos = __LDREXW(&recorder->head);
+	while (__STREXW(pos + 1, &recorder->head));
+
+	return pos;
+}
+
+/**
+ * @brief	Add a record, it can be called from interrupt handlers.
+ *
+ * @param	event The record event.
+ * @param	type The message type.
+ * @param	src Index of the source service.
+ * @param	dst Index of the destination service.
+ * @param	message Pointer to the message.
+ *
+ * @retval	None.
+ */
+void flight_recorder_record(flight_record_event_t	event,
+			    message_type_t		type,
+			    unsigned int		src,
+			    unsigned int		dst,
+			    const message_t *		message)
+{
+	flight_recorder_t *recorder = &flight_recorder;
+	flight_record_t *record;
+	uint32_t pos;
+
+	if (!flight_recorder_ready)
+		return;
+
+	pos = flight_recorder_claim(recorder);
+	record = &recorder->record[pos & (CONFIG_FLIGHT_RECORDER_RECORD_NUM - 1)];
+
+	record->timestamp = osKernelGetTickCount();
+	record->event = event;
+	record->type = type;
+	record->src = src < FLIGHT_RECORD_NO_SERVICE ?
+		      src : FLIGHT_RECORD_NO_SERVICE;
+	record->dst = dst < FLIGHT_RECORD_NO_SERVICE ?
+		      dst : FLIGHT_RECORD_NO_SERVICE;
+	record->id = message ? message->id : 0;
+	record->param0 = message ? message->param0 : 0;
+	record->param1 = message ? message->param1 : 0;
+}
+
+/**
+ * @brief	Read a record.
+ *
+ * @param	age Age of the record, 0 for the newest one.
+ * @param	record Pointer to the record copy.
+ *
+ * @note	A record written at the same time may be read half updated.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int flight_recorder_read(unsigned int age, flight_record_t *record)
+{
+	flight_recorder_t *recorder = &flight_recorder;
+	uint32_t head = recorder->head;
+
+	if (!record)
+		return -EINVAL;
+
+	if (!flight_recorder_ready)
+		return -EIO;
+
+	if (age >= CONFIG_FLIGHT_RECORDER_RECORD_NUM || age >= head)
+		return -ENOENT;
+
+	*record = recorder->record[(head - 1 - age) &
+				   (CONFIG_FLIGHT_RECORDER_RECORD_NUM - 1)];
+
+	return 0;
+}
+
+/**
+ * @brief	Get the service name of a record.
+ *
+ * @param	index Index of the service.
+ *
+ * @retval	Returns the service name.
+ */
+static const char *flight_recorder_service_name(unsigned int index)
+{
+	const service_t *svc;
+
+	if (index == FLIGHT_RECORD_NO_SERVICE)
+		return "-";
+
+	svc = service_get_binding_by_index(index);
+	if (!svc)
+		return "?";
+
+	return service_get_name(svc);
+}
+
+/**
+ * @brief	Print the records from the oldest to the newest one.
+ *
+ * @param	None.
+ *
+ * @note	The output goes through printf(), so it also works from the
+ *		assert path with the scheduler locked.
+ *
+ * @retval	None.
+ */
+void flight_recorder_dump(void)
+{
+	static const char *const event_name[] = {
+		[FLIGHT_RECORD_BOOT]		= "boot",
+		[FLIGHT_RECORD_SEND]		= "send",
+		[FLIGHT_RECORD_SEND_FAIL]	= "fail",
+		[FLIGHT_RECORD_DISPATCH]	= "dispatch",
+	};
+	flight_record_t record;
+	unsigned int age;
+
+	if (!flight_recorder_ready)
+		return;
+
+	printf("flight recorder, head %u:\r\n",
+	       (unsigned int)flight_recorder.head);
+
+	age = CONFIG_FLIGHT_RECORDER_RECORD_NUM;
+	while (age--) {
+		if (flight_recorder_read(age, &record))
+			continue;
+
+		printf("%10u %-8s %u <%s> -> <%s> 0x%08x 0x%08x 0x%08x\r\n",
+		       (unsigned int)record.timestamp,
+		       record.event <= FLIGHT_RECORD_DISPATCH ?
+		       event_name[record.event] : "?",
+		       (unsigned int)record.type,
+		       flight_recorder_service_name(record.src),
+		       flight_recorder_service_name(record.dst),
+		       (unsigned int)record.id,
+		       (unsigned int)record.param0,
+		       (unsigned int)record.param1);
+	}
+}
+
+/**
+ * @brief	Probe the flight recorder.
+ *
+ * @param	obj Pointer to the recorder object handle.
+ *
+ * @note	The records of the previous run are kept if the section
+ *		survived the reset.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int flight_recorder_probe(const object *obj)
+{
+	flight_recorder_t *recorder = (flight_recorder_t *)obj->object_data;
+
+	if (recorder->magic != FLIGHT_RECORDER_MAGIC) {
+		(void)memset(recorder, 0, sizeof(flight_recorder_t));
+		recorder->magic = FLIGHT_RECORDER_MAGIC;
+	}
+
+	flight_recorder_ready = 1;
+
+	flight_recorder_record(FLIGHT_RECORD_BOOT,
+			       MSG_TYPE_INT,
+			       FLIGHT_RECORD_NO_SERVICE,
+			       FLIGHT_RECORD_NO_SERVICE,
+			       NULL);
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+/**
+ * @brief	Remove the flight recorder.
+ *
+ * @param	obj Pointer to the recorder object handle.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int flight_recorder_shutdown(const object *obj)
+{
+	(void)obj;
+
+	flight_recorder_ready = 0;
+
+	return 0;
+}
+
+module_pre(CONFIG_FLIGHT_RECORDER_NAME,
+	   CONFIG_FLIGHT_RECORDER_LABEL,
+	   flight_recorder_probe,
+	   flight_recorder_shutdown,
+	   NULL, &flight_recorder, NULL);
+
+#endif
@@ -22,6 +22,7 @@
 #include "log.h"
 #include "framework_conf.h"
 #include "service.h"
+#include "boot_profile.h"
 
 /**
  * @brief   Startup hardware early.
@@ -76,7 +77,6 @@ const osThreadAttr_t init_attr = {
 static void init_thread(void *argument)
 {
 	message_t message;
-	osStatus_t stat;
 	int ret;
 
 	(void)argument;
@@ -89,7 +89,11 @@ static void init_thread(void *argument)
 
 	hardware_late_startup();
 
-	osDelay(500 * osKernelGetTickFreq() / 1000);
+	ret = service_wait_ready(CONFIG_SERVICE_READY_TIMEOUT_MS);
+	if (ret)
+		pr_error("Some services are not ready, startup anyway.");
+	else
+		pr_info("All services ready.");
 
 	message.id = MSG_ID_SYS_STARTUP_COMPLETED;
 	message.param0 = 0;
@@ -101,11 +105,11 @@ static void init_thread(void *argument)
 	else
 		pr_info("Broadcast event 0x%x succeed.", message.id);
 
-	stat = osThreadSuspend(osThreadGetId());
-	if (stat != osOK)
-		pr_error("Suspend thread <%s> failed, stat = %d.",
-			 osThreadGetName(osThreadGetId()),
-			 stat);
+	boot_profile_complete();
+	boot_profile_dump();
+
+	/* The stack and the control block go back to the heap */
+	osThreadExit();
 }
 
 __attribute__((noreturn))
@@ -116,6 +120,8 @@ int main(int argc, char *argv[])
 
 	hardware_early_startup();
 
+	boot_profile_start();
+
 	stat = osKernelInitialize();
 	if (stat != osOK)
 		pr_error("Kernel initialize failed, stat = %d.", stat);
@@ -22,3 +22,200 @@
 #include "err.h"
 #include "log.h"
 #include "message.h"
+
+#if defined(CONFIG_MSG_PAYLOAD_POOL_ENABLE)
+
+/**
+ * @brief	Payload block structure definitions.
+ */
+typedef struct _message_payload_block_t {
+	struct _message_payload_block_t *	next;
+	unsigned int				refcnt;
+	unsigned long long			data[(CONFIG_MSG_PAYLOAD_BLOCK_SIZE +
+						      sizeof(unsigned long long) - 1) /
+						     sizeof(unsigned long long)];
+} message_payload_block_t;
+
+/**
+ * @brief	Payload pool handle definition.
+ */
+typedef struct {
+	message_payload_block_t *	free_list;
+	unsigned int			free_num;
+	int				initialized;
+} message_payload_pool_t;
+
+static message_payload_block_t
+	message_payload_blocks[CONFIG_MSG_PAYLOAD_BLOCK_NUM];
+static message_payload_pool_t message_payload_pool;
+
+#define message_payload_to_block(payload) \
+	((message_payload_block_t *)((char *)(payload) - \
+				     offsetof(message_payload_block_t, data)))
+
+/**
+ * @brief	Link all the blocks to the free list.
+ *
+ * @param	pool Pointer to the payload pool handle.
+ *
+ * @retval	None.
+ *
+ * @note	Must be called with the kernel locked.
+ */
+static void message_payload_pool_init(message_payload_pool_t *pool)
+{
+	int i;
+
+	pool->free_list = NULL;
+
+	for (i = CONFIG_MSG_PAYLOAD_BLOCK_NUM - 1; i >= 0; i--) {
+		message_payload_blocks[i].refcnt = 0;
+		message_payload_blocks[i].next = pool->free_list;
+		pool->free_list = &message_payload_blocks[i];
+	}
+
+	pool->free_num = CONFIG_MSG_PAYLOAD_BLOCK_NUM;
+	pool->initialized = 1;
+}
+
+/**
+ * @brief	Check whether the pointer is a payload from the pool.
+ *
+ * @param	payload Pointer to check.
+ *
+ * @retval	Returns 1 if the pointer is a pool payload, 0 otherwise.
+ */
+int message_payload_is_valid(const void *payload)
+{
+	const char *start = (const char *)message_payload_blocks[0].data;
+	const char *end =
+		(const char *)&message_payload_blocks[CONFIG_MSG_PAYLOAD_BLOCK_NUM];
+	const char *ptr = (const char *)payload;
+
+	if (ptr < start || ptr >= end)
+		return 0;
+
+	if ((ptr - start) % sizeof(message_payload_block_t))
+		return 0;
+
+	return 1;
+}
+
+/**
+ * @brief	Allocate a payload from the pool.
+ *
+ * @param	size Requested payload size in bytes.
+ *
+ * @retval	Payload pointer holding one reference, or NULL in case of error.
+ */
+void *message_payload_alloc(unsigned int size)
+{
+	message_payload_pool_t *pool = &message_payload_pool;
+	message_payload_block_t *block;
+	int32_t lock;
+
+	if (size > CONFIG_MSG_PAYLOAD_BLOCK_SIZE)
+		return NULL;
+
+	lock = osKernelLock();
+
+	if (!pool->initialized)
+		message_payload_pool_init(pool);
+
+	block = pool->free_list;
+	if (block) {
+		pool->free_list = block->next;
+		pool->free_num--;
+		block->next = NULL;
+		block->refcnt = 1;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	if (!block)
+		return NULL;
+
+	return block->data;
+}
+
+/**
+ * @brief	Take one more reference on a payload.
+ *
+ * @param	payload Pointer to the payload.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int message_payload_get(const void *payload)
+{
+	message_payload_block_t *block;
+	int32_t lock;
+	int ret = 0;
+
+	if (!message_payload_is_valid(payload))
+		return -EINVAL;
+
+	block = message_payload_to_block(payload);
+
+	lock = osKernelLock();
+
+	if (block->refcnt)
+		block->refcnt++;
+	else
+		ret = -EINVAL;
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Drop one reference on a payload,
+ *		the block is returned to the pool with the last reference.
+ *
+ * @param	payload Pointer to the payload.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int message_payload_put(const void *payload)
+{
+	message_payload_pool_t *pool = &message_payload_pool;
+	message_payload_block_t *block;
+	int32_t lock;
+	int ret = 0;
+
+	if (!message_payload_is_valid(payload))
+		return -EINVAL;
+
+	block = message_payload_to_block(payload);
+
+	lock = osKernelLock();
+
+	if (!block->refcnt) {
+		ret = -EINVAL;
+	} else if (!--block->refcnt) {
+		block->next = pool->free_list;
+		pool->free_list = block;
+		pool->free_num++;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Get the number of free payloads in the pool.
+ *
+ * @retval	Returns the number of free payloads.
+ */
+unsigned int message_payload_get_free_num(void)
+{
+	message_payload_pool_t *pool = &message_payload_pool;
+
+	if (!pool->initialized)
+		return CONFIG_MSG_PAYLOAD_BLOCK_NUM;
+
+	return pool->free_num;
+}
+
+#endif
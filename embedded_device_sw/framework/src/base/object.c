@@ -19,8 +19,12 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "cmsis_os2.h"
 #include "object.h"
 #include "err.h"
+#include "log.h"
+#include "boot_profile.h"
+#include "framework_conf.h"
 
 extern object module_object_0$$Base[];
 extern object module_object_0$$Limit[];
@@ -36,6 +40,8 @@ extern object module_object_5$$Base[];
 extern object module_object_5$$Limit[];
 extern object module_object_6$$Base[];
 extern object module_object_6$$Limit[];
+extern object_depends_t module_object_depends$$Base[];
+extern object_depends_t module_object_depends$$Limit[];
 
 /**
  * @brief   Define object levels.
@@ -60,6 +66,139 @@ static object *object_levels[] =
 
 #define OBJECT_LEVELS_NUM (sizeof(object_levels) / sizeof(object_levels[0]))
 
+/**
+ * The hash table is kept at most half full,
+ * so a lookup normally ends on the first or second probe.
+ */
+#define OBJECT_INDEX_HASH_SIZE (CONFIG_OBJECT_INDEX_MAX_NUM * 2)
+#define OBJECT_INDEX_HASH_MASK (OBJECT_INDEX_HASH_SIZE - 1)
+#define OBJECT_INDEX_EMPTY     (-1)
+
+#if (CONFIG_OBJECT_INDEX_MAX_NUM & (CONFIG_OBJECT_INDEX_MAX_NUM - 1))
+#error "CONFIG_OBJECT_INDEX_MAX_NUM must be a power of two."
+#endif
+
+/**
+ * @brief   Object index definitions.
+ *
+ * Objects are numbered in initialization order, the ID is the position
+ * in the table. The hash table maps object names to IDs.
+ */
+typedef struct {
+	const object *	table[CONFIG_OBJECT_INDEX_MAX_NUM];
+	short		hash[OBJECT_INDEX_HASH_SIZE];
+	short		level_first[OBJECT_LEVELS_NUM / 2 + 1];
+	int		num;
+	int		state;
+} object_index_t;
+
+#define OBJECT_INDEX_STATE_NONE     0
+#define OBJECT_INDEX_STATE_READY    1
+#define OBJECT_INDEX_STATE_OVERFLOW 2
+
+static object_index_t object_index;
+
+/**
+ * @brief   Compute the hash value of an object name (32 bits FNV-1a).
+ *
+ * @param   name Object name.
+ *
+ * @retval  Returns the hash value.
+ */
+unsigned int object_hash_name(const char *name)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*name) {
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief   Build the object index, it is done only once.
+ *
+ * @param   None.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int object_index_build(void)
+{
+	object_index_t *index = &object_index;
+	const object *obj;
+	unsigned int slot;
+	int level;
+	int id;
+
+	if (index->state == OBJECT_INDEX_STATE_READY)
+		return 0;
+
+	if (index->state == OBJECT_INDEX_STATE_OVERFLOW)
+		return -ENOMEM;
+
+	for (slot = 0; slot < OBJECT_INDEX_HASH_SIZE; slot++)
+		index->hash[slot] = OBJECT_INDEX_EMPTY;
+
+	index->num = 0;
+
+	for (level = 0; level < OBJECT_LEVELS_NUM; level += 2) {
+		index->level_first[level / 2] = index->num;
+
+		for (obj = object_levels[level]; obj < object_levels[level + 1];
+		     obj++) {
+			if (index->num >= CONFIG_OBJECT_INDEX_MAX_NUM) {
+				index->state = OBJECT_INDEX_STATE_OVERFLOW;
+				return -ENOMEM;
+			}
+
+			id = index->num++;
+			index->table[id] = obj;
+
+			/* Only objects with API can be bound by name */
+			if (!obj->object_intf)
+				continue;
+
+			slot = object_hash_name(obj->name) & OBJECT_INDEX_HASH_MASK;
+			while (index->hash[slot] != OBJECT_INDEX_EMPTY) {
+				/* The first object with the name wins */
+				if (!strcmp(obj->name,
+					    index->table[index->hash[slot]]->name))
+					break;
+				slot = (slot + 1) & OBJECT_INDEX_HASH_MASK;
+			}
+
+			if (index->hash[slot] == OBJECT_INDEX_EMPTY)
+				index->hash[slot] = id;
+		}
+	}
+
+	index->level_first[OBJECT_LEVELS_NUM / 2] = index->num;
+	index->state = OBJECT_INDEX_STATE_READY;
+
+	return 0;
+}
+
+/**
+ * @brief   Probe an object, the probe is timed by the boot profiler.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int object_probe_call(const object *obj)
+{
+	uint32_t begin;
+	int ret;
+
+	begin = boot_profile_begin();
+	ret = obj->probe(obj);
+	boot_profile_end(BOOT_PROFILE_PROBE, obj->name, begin);
+
+	return ret;
+}
+
 /**
  * @brief   Initialize one object.
  *
@@ -75,7 +214,7 @@ static int object_do_one_initcall(int level)
 	for (obj = object_levels[level]; obj < object_levels[level + 1];
 	     obj++) {
 		if (obj && obj->probe) {
-			ret = obj->probe(obj);
+			ret = object_probe_call(obj);
 			if (ret)
 				return ret;
 		}
@@ -84,24 +223,998 @@ static int object_do_one_initcall(int level)
 	return 0;
 }
 
+#define OBJECT_PROBE_STATE_NONE    0
+#define OBJECT_PROBE_STATE_RUNNING 1
+#define OBJECT_PROBE_STATE_DONE    2
+
+#define OBJECT_DEPENDS_READY 0
+#define OBJECT_DEPENDS_WAIT  1
+
+/**
+ * @brief   Object probe runtime definitions, indexed by object ID.
+ */
+typedef struct {
+	const object_depends_t *	depends;
+	volatile int			state;
+	volatile int			status;
+	unsigned int			refs;           /* lazy objects */
+	unsigned int			idle;
+	uint32_t			idle_since;
+} object_probe_t;
+
+static object_probe_t object_probe[CONFIG_OBJECT_INDEX_MAX_NUM];
+
+/**
+ * @brief   Lazy object runtime definitions.
+ *
+ * The mutex serializes the lazy probes and shutdowns, it is recursive as a
+ * lazy probe may bind the lazy objects it depends on. The idle timer only
+ * wakes the lazy thread up, the shutdowns run on the thread's stack.
+ */
+typedef struct {
+	osMutexId_t	mutex_id;
+	osTimerId_t	timer_id;
+	osThreadId_t	thread_id;
+	unsigned int	idle_num;
+} object_lazy_t;
+
+#define OBJECT_LAZY_FLAG_IDLE 0x00000001U
+
+static object_lazy_t object_lazy;
+
+static const osMutexAttr_t object_lazy_mutex_attr = {
+	.name		= CONFIG_OBJECT_LAZY_MUTEX_NAME,
+	.attr_bits	= osMutexRecursive | osMutexPrioInherit,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+};
+
+static const osTimerAttr_t object_lazy_timer_attr = {
+	.name		= CONFIG_OBJECT_LAZY_TIMER_NAME,
+	.attr_bits	= 0,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+};
+
+static const osThreadAttr_t object_lazy_thread_attr = {
+	.name		= CONFIG_OBJECT_LAZY_THREAD_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_OBJECT_LAZY_THREAD_STACK_SIZE,
+	.priority	= CONFIG_OBJECT_LAZY_THREAD_PRIORITY,
+};
+
+#define OBJECT_LAZY_IDLE_TICKS \
+	(CONFIG_OBJECT_LAZY_IDLE_MS * osKernelGetTickFreq() / 1000)
+
+/**
+ * @brief   Object init worker pool definitions.
+ */
+typedef struct {
+	osMessageQueueId_t	work_queue_id;
+	osMessageQueueId_t	done_queue_id;
+	int			worker_num;
+} object_init_pool_t;
+
+static object_init_pool_t object_init_pool;
+
+static const osThreadAttr_t object_init_worker_attr = {
+	.name		= CONFIG_OBJECT_INIT_WORKER_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_OBJECT_INIT_WORKER_STACK_SIZE,
+	.priority	= CONFIG_OBJECT_INIT_WORKER_PRIORITY,
+};
+
+/**
+ * @brief   Search an object ID by name, objects without API included.
+ *
+ * @param   name Object name.
+ *
+ * @retval  Returns the object ID on success, negative error code otherwise.
+ */
+static int object_search_id(const char *name)
+{
+	object_index_t *index = &object_index;
+	int id;
+
+	id = object_get_id(name);
+	if (id >= 0)
+		return id;
+
+	for (id = 0; id < index->num; id++)
+		if (!strcmp(name, index->table[id]->name))
+			return id;
+
+	return -ENODEV;
+}
+
+/**
+ * @brief   Get the ID of an object from its handle.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns the object ID on success, negative error code otherwise.
+ */
+static int object_get_handle_id(const object *obj)
+{
+	object_index_t *index = &object_index;
+	int level;
+
+	if (index->state != OBJECT_INDEX_STATE_READY)
+		return -ENODEV;
+
+	/* IDs are given in section order */
+	for (level = 0; level < OBJECT_LEVELS_NUM; level += 2)
+		if (obj >= object_levels[level] &&
+		    obj < object_levels[level + 1])
+			return index->level_first[level / 2] +
+			       (obj - object_levels[level]);
+
+	return -ENODEV;
+}
+
+/**
+ * @brief   Check whether an object has to be probed at boot.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  Returns 1 if the object is lazy, 0 otherwise.
+ */
+static int object_is_lazy(int id)
+{
+	return (object_index.table[id]->flags & OBJECT_FLAG_LAZY) ? 1 : 0;
+}
+
+/**
+ * @brief   Attach the dependency declarations to the objects.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void object_depends_bind(void)
+{
+	const object_depends_t *depends;
+	int id;
+
+	for (depends = module_object_depends$$Base;
+	     depends < module_object_depends$$Limit; depends++) {
+		id = object_search_id(depends->name);
+		if (id < 0) {
+			pr_warning("Depends of object <%s> ignored, no object.",
+				   depends->name);
+			continue;
+		}
+
+		object_probe[id].depends = depends;
+	}
+}
+
+/**
+ * @brief   Check whether the dependencies of an object are probed.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  Returns OBJECT_DEPENDS_READY or OBJECT_DEPENDS_WAIT,
+ *          negative error code if the object has to be canceled.
+ */
+static int object_depends_check(int id)
+{
+	const object_depends_t *depends = object_probe[id].depends;
+	const object *obj = object_index.table[id];
+	int ret = OBJECT_DEPENDS_READY;
+	unsigned int i;
+	int dep;
+
+	if (!depends)
+		return OBJECT_DEPENDS_READY;
+
+	for (i = 0; i < depends->depends_num; i++) {
+		dep = object_search_id(depends->depends[i]);
+		if (dep < 0) {
+			pr_error("Object <%s> depends on <%s>, no object.",
+				 obj->name,
+				 depends->depends[i]);
+			return -ENODEV;
+		}
+
+		/* Lazy dependencies are probed on demand */
+		if (object_is_lazy(dep))
+			continue;
+
+		if (object_probe[dep].state != OBJECT_PROBE_STATE_DONE) {
+			ret = OBJECT_DEPENDS_WAIT;
+			continue;
+		}
+
+		if (object_probe[dep].status) {
+			pr_error("Object <%s> canceled, <%s> failed.",
+				 obj->name,
+				 depends->depends[i]);
+			return -ECANCELED;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * @brief   Lock the lazy objects.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ *
+ * @note    Before object_init() there is only one thread, nothing to lock.
+ */
+static void object_lazy_lock(void)
+{
+	if (object_lazy.mutex_id)
+		(void)osMutexAcquire(object_lazy.mutex_id, osWaitForever);
+}
+
+/**
+ * @brief   Unlock the lazy objects.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void object_lazy_unlock(void)
+{
+	if (object_lazy.mutex_id)
+		(void)osMutexRelease(object_lazy.mutex_id);
+}
+
+/**
+ * @brief   Mark a lazy object without reference, start the idle timer.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  None.
+ *
+ * @note    It must be called with the lazy objects locked.
+ */
+static void object_lazy_idle(int id)
+{
+	object_lazy_t *lazy = &object_lazy;
+	object_probe_t *probe = &object_probe[id];
+
+	if (!lazy->timer_id || probe->idle ||
+	    probe->state != OBJECT_PROBE_STATE_DONE || probe->status)
+		return;
+
+	probe->idle = 1;
+	probe->idle_since = osKernelGetTickCount();
+	lazy->idle_num++;
+
+	if (!osTimerIsRunning(lazy->timer_id))
+		(void)osTimerStart(lazy->timer_id, OBJECT_LAZY_IDLE_TICKS);
+}
+
+/**
+ * @brief   Mark a lazy object in use again.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  None.
+ *
+ * @note    It must be called with the lazy objects locked.
+ */
+static void object_lazy_busy(int id)
+{
+	object_probe_t *probe = &object_probe[id];
+
+	if (probe->idle) {
+		probe->idle = 0;
+		object_lazy.idle_num--;
+	}
+}
+
+static int object_lazy_hold(int id);
+static void object_probe_done(int id, int status);
+
+/**
+ * @brief   Hold the lazy objects an object depends on.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    A lazy dependency is probed here. It is held as long as the
+ *          object is probed, and released by its shutdown or by a failed
+ *          probe. The other dependencies are only checked.
+ */
+static int object_depends_hold(int id)
+{
+	const object_depends_t *depends = object_probe[id].depends;
+	const object *obj = object_index.table[id];
+	unsigned int i;
+	int ret = 0;
+	int dep;
+
+	if (!depends)
+		return 0;
+
+	object_lazy_lock();
+
+	for (i = 0; i < depends->depends_num; i++) {
+		dep = object_search_id(depends->depends[i]);
+		if (dep < 0)
+			ret = -ENODEV;
+		else if (object_is_lazy(dep))
+			ret = object_lazy_hold(dep) ? -ECANCELED : 0;
+		else if (object_probe[dep].state != OBJECT_PROBE_STATE_DONE)
+			ret = -EAGAIN;
+		else
+			ret = object_probe[dep].status ? -ECANCELED : 0;
+
+		if (ret) {
+			pr_error("Object <%s> depends on <%s>, ret %d.",
+				 obj->name,
+				 depends->depends[i],
+				 ret);
+			break;
+		}
+	}
+
+	/* Undo the holds taken so far */
+	if (ret)
+		while (i--) {
+			dep = object_search_id(depends->depends[i]);
+			if (object_is_lazy(dep) && !--object_probe[dep].refs)
+				object_lazy_idle(dep);
+		}
+
+	object_lazy_unlock();
+
+	return ret;
+}
+
+/**
+ * @brief   Release the lazy objects an object depends on.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  None.
+ *
+ * @note    It must be called with the lazy objects locked.
+ */
+static void object_depends_release(int id)
+{
+	const object_depends_t *depends = object_probe[id].depends;
+	unsigned int i;
+	int dep;
+
+	if (!depends)
+		return;
+
+	for (i = 0; i < depends->depends_num; i++) {
+		dep = object_search_id(depends->depends[i]);
+		if (dep >= 0 && object_is_lazy(dep) && object_probe[dep].refs &&
+		    !--object_probe[dep].refs)
+			object_lazy_idle(dep);
+	}
+}
+
+/**
+ * @brief   Release the lazy objects held by an object.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  None.
+ */
+static void object_depends_put(int id)
+{
+	object_lazy_lock();
+	object_depends_release(id);
+	object_lazy_unlock();
+}
+
+/**
+ * @brief   Probe a lazy object if needed and take a reference on it.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    A lazy object is probed once, by the first binding. A failed
+ *          probe is not retried, but a dependency which is not probed yet
+ *          is, on the next binding.
+ */
+static int object_lazy_hold(int id)
+{
+	object_probe_t *probe = &object_probe[id];
+	const object *obj = object_index.table[id];
+	int ret;
+
+	object_lazy_lock();
+
+	if (probe->state == OBJECT_PROBE_STATE_RUNNING) {
+		/* Bound again by its own probe, a dependency loop */
+		object_lazy_unlock();
+		return -EDEADLK;
+	}
+
+	if (probe->state == OBJECT_PROBE_STATE_NONE) {
+		probe->state = OBJECT_PROBE_STATE_RUNNING;
+
+		ret = object_depends_hold(id);
+		if (ret == -EAGAIN) {
+			probe->state = OBJECT_PROBE_STATE_NONE;
+			object_lazy_unlock();
+			return ret;
+		}
+
+		if (!ret && obj->probe) {
+			ret = object_probe_call(obj);
+			if (ret)
+				object_depends_release(id);
+		}
+
+		object_probe_done(id, ret);
+	}
+
+	ret = probe->status;
+	if (!ret) {
+		probe->refs++;
+		object_lazy_busy(id);
+	}
+
+	object_lazy_unlock();
+
+	return ret;
+}
+
+/**
+ * @brief   Shut down a lazy object which has been idle for too long.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  None.
+ *
+ * @note    It must be called with the lazy objects locked.
+ */
+static void object_lazy_shutdown(int id)
+{
+	object_probe_t *probe = &object_probe[id];
+	const object *obj = object_index.table[id];
+	int ret;
+
+	object_lazy_busy(id);
+
+	ret = obj->shutdown ? obj->shutdown(obj) : 0;
+	if (ret) {
+		/* Keep it probed, it is not tried again until the next idle */
+		pr_error("Object <%s> idle shutdown failed, ret %d.",
+			 obj->name,
+			 ret);
+		return;
+	}
+
+	probe->state = OBJECT_PROBE_STATE_NONE;
+	object_depends_release(id);
+
+	pr_info("Object <%s> idle, shutdown.", obj->name);
+}
+
+/**
+ * @brief   Idle timer callback, wake the lazy thread up.
+ *
+ * @param   argument Pointer to the lazy objects runtime.
+ *
+ * @retval  None.
+ *
+ * @note    The shutdowns are not done here, the timer daemon stack is too
+ *          small for the driver shutdowns and their traces.
+ */
+static void object_lazy_timer_callback(void *argument)
+{
+	object_lazy_t *lazy = (object_lazy_t *)argument;
+
+	(void)osThreadFlagsSet(lazy->thread_id, OBJECT_LAZY_FLAG_IDLE);
+}
+
+/**
+ * @brief   Lazy thread, shut down the lazy objects idle for too long.
+ *
+ * @param   argument Pointer to the lazy objects runtime.
+ *
+ * @retval  None.
+ *
+ * @note    The timer keeps running while some lazy object is idle, so an
+ *          object is shut down between one and two idle periods after its
+ *          last reference was released.
+ */
+static void object_lazy_thread(void *argument)
+{
+	object_lazy_t *lazy = (object_lazy_t *)argument;
+	object_index_t *index = &object_index;
+	uint32_t flags;
+	uint32_t now;
+	int id;
+
+	while (1) {
+		flags = osThreadFlagsWait(OBJECT_LAZY_FLAG_IDLE,
+					  osFlagsWaitAny,
+					  osWaitForever);
+		if (flags & osFlagsError)
+			continue;
+
+		object_lazy_lock();
+
+		now = osKernelGetTickCount();
+
+		for (id = 0; id < index->num; id++)
+			if (object_probe[id].idle &&
+			    now - object_probe[id].idle_since >=
+			    OBJECT_LAZY_IDLE_TICKS)
+				object_lazy_shutdown(id);
+
+		if (!lazy->idle_num)
+			(void)osTimerStop(lazy->timer_id);
+
+		object_lazy_unlock();
+	}
+}
+
+/**
+ * @brief   Create the lock, the thread and the idle timer of the lazy objects.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ *
+ * @note    Without the timer, the lazy objects are never shut down.
+ */
+static void object_lazy_start(void)
+{
+	object_lazy_t *lazy = &object_lazy;
+
+	if (!lazy->mutex_id)
+		lazy->mutex_id = osMutexNew(&object_lazy_mutex_attr);
+
+	if (!lazy->mutex_id || lazy->timer_id || !CONFIG_OBJECT_LAZY_IDLE_MS)
+		return;
+
+	lazy->thread_id = osThreadNew(object_lazy_thread,
+				      lazy,
+				      &object_lazy_thread_attr);
+	if (!lazy->thread_id) {
+		pr_warning("Lazy objects thread create failed.");
+		return;
+	}
+
+	lazy->timer_id = osTimerNew(object_lazy_timer_callback,
+				    osTimerPeriodic,
+				    lazy,
+				    &object_lazy_timer_attr);
+	if (!lazy->timer_id)
+		pr_warning("Lazy objects idle timer create failed.");
+}
+
+/**
+ * @brief   Object init worker thread, probes the objects it is given.
+ *
+ * @param   argument Pointer to the worker pool.
+ *
+ * @retval  None.
+ */
+static void object_init_worker_thread(void *argument)
+{
+	object_init_pool_t *pool = (object_init_pool_t *)argument;
+	const object *obj;
+	short id;
+
+	while (1) {
+		if (osMessageQueueGet(pool->work_queue_id, &id, NULL,
+				      osWaitForever) != osOK)
+			continue;
+
+		if (id >= 0) {
+			obj = object_index.table[id];
+			object_probe[id].status = object_probe_call(obj);
+		}
+
+		(void)osMessageQueuePut(pool->done_queue_id, &id, 0,
+					osWaitForever);
+
+		/* A negative ID asks the worker to exit */
+		if (id < 0)
+			break;
+	}
+
+	osThreadExit();
+}
+
+/**
+ * @brief   Start the object init workers.
+ *
+ * @param   pool Pointer to the worker pool.
+ *
+ * @retval  None.
+ *
+ * @note    The objects are probed in the caller's thread if no worker can
+ *          be created.
+ */
+static void object_init_pool_start(object_init_pool_t *pool)
+{
+	int i;
+
+	pool->worker_num = 0;
+
+	if (CONFIG_OBJECT_INIT_WORKER_NUM <= 0)
+		return;
+
+	pool->work_queue_id = osMessageQueueNew(CONFIG_OBJECT_INIT_WORKER_NUM,
+						sizeof(short),
+						NULL);
+	pool->done_queue_id = osMessageQueueNew(CONFIG_OBJECT_INIT_WORKER_NUM,
+						sizeof(short),
+						NULL);
+	if (!pool->work_queue_id || !pool->done_queue_id)
+		return;
+
+	for (i = 0; i < CONFIG_OBJECT_INIT_WORKER_NUM; i++) {
+		if (!osThreadNew(object_init_worker_thread,
+				 pool,
+				 &object_init_worker_attr))
+			break;
+
+		pool->worker_num++;
+	}
+}
+
+/**
+ * @brief   Stop the object init workers and release the pool.
+ *
+ * @param   pool Pointer to the worker pool.
+ *
+ * @retval  None.
+ */
+static void object_init_pool_stop(object_init_pool_t *pool)
+{
+	short id = -1;
+	int i;
+
+	for (i = 0; i < pool->worker_num; i++)
+		(void)osMessageQueuePut(pool->work_queue_id, &id, 0,
+					osWaitForever);
+
+	/* Wait until every worker is done with the queues */
+	for (i = 0; i < pool->worker_num; i++)
+		(void)osMessageQueueGet(pool->done_queue_id, &id, NULL,
+					osWaitForever);
+
+	if (pool->work_queue_id)
+		(void)osMessageQueueDelete(pool->work_queue_id);
+
+	if (pool->done_queue_id)
+		(void)osMessageQueueDelete(pool->done_queue_id);
+
+	pool->work_queue_id = NULL;
+	pool->done_queue_id = NULL;
+	pool->worker_num = 0;
+}
+
+/**
+ * @brief   Record the probe result of an object.
+ *
+ * @param   id Object ID.
+ * @param   status The probe result.
+ *
+ * @retval  None.
+ */
+static void object_probe_done(int id, int status)
+{
+	object_probe[id].status = status;
+	object_probe[id].state = OBJECT_PROBE_STATE_DONE;
+
+	if (status && status != -ECANCELED)
+		pr_error("Object <%s> probe failed, ret %d.",
+			 object_index.table[id]->name,
+			 status);
+}
+
+/**
+ * @brief   Probe the objects of a level in dependency order.
+ *
+ * @param   pool Pointer to the worker pool.
+ * @param   first ID of the first object of the level.
+ * @param   last ID after the last object of the level.
+ *
+ * @retval  Returns 0 on success, the first error of the level otherwise.
+ *
+ * @note    A probed object keeps the lazy objects it depends on until it
+ *          is shut down.
+ */
+static int object_init_level(object_init_pool_t *	pool,
+				   int			first,
+				   int			last)
+{
+	const object *obj;
+	int remain = 0;
+	int running = 0;
+	int progress;
+	int ret = 0;
+	short id;
+	int stat;
+
+	/* The lazy objects are probed on their first binding */
+	for (id = first; id < last; id++)
+		if (!object_is_lazy(id))
+			remain++;
+
+	while (remain) {
+		progress = 0;
+
+		for (id = first; id < last; id++) {
+			if (object_probe[id].state != OBJECT_PROBE_STATE_NONE ||
+			    object_is_lazy(id))
+				continue;
+
+			stat = object_depends_check(id);
+			if (stat == OBJECT_DEPENDS_WAIT)
+				continue;
+
+			obj = object_index.table[id];
+
+			/* Every worker is busy, try again later, nothing held */
+			if (stat == OBJECT_DEPENDS_READY && obj->probe &&
+			    pool->worker_num && running >= pool->worker_num)
+				continue;
+
+			/* Probe the lazy dependencies now, held during the probe */
+			if (stat == OBJECT_DEPENDS_READY && obj->probe)
+				stat = object_depends_hold(id);
+
+			if (stat < 0 || !obj->probe) {
+				object_probe_done(id, stat < 0 ? stat : 0);
+			} else if (pool->worker_num) {
+				object_probe[id].state =
+					OBJECT_PROBE_STATE_RUNNING;
+				(void)osMessageQueuePut(pool->work_queue_id,
+							&id, 0, osWaitForever);
+				running++;
+				progress = 1;
+				continue;
+			} else {
+				object_probe_done(id, object_probe_call(obj));
+				if (object_probe[id].status)
+					object_depends_put(id);
+			}
+
+			if (object_probe[id].status && !ret)
+				ret = object_probe[id].status;
+
+			remain--;
+			progress = 1;
+		}
+
+		if (running) {
+			(void)osMessageQueueGet(pool->done_queue_id, &id, NULL,
+						osWaitForever);
+			object_probe_done(id, object_probe[id].status);
+			if (object_probe[id].status)
+				object_depends_put(id);
+			if (object_probe[id].status && !ret)
+				ret = object_probe[id].status;
+			running--;
+			remain--;
+		} else if (!progress) {
+			/* A dependency loop, or a dependency on a later level */
+			for (id = first; id < last; id++)
+				if (object_probe[id].state ==
+				    OBJECT_PROBE_STATE_NONE &&
+				    !object_is_lazy(id)) {
+					pr_error("Object <%s> canceled, "
+						 "dependency never probed.",
+						 object_index.table[id]->name);
+					object_probe_done(id, -EDEADLK);
+				}
+
+			return ret ? ret : -EDEADLK;
+		}
+	}
+
+	return ret;
+}
+
 /**
  * @brief   Execute all the object initialization functions at a given level.
  *
  * @param   None.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    A failed object only cancels the objects depending on it, the
+ *          other objects are still probed. The first error is returned.
+ *          The lazy objects are skipped, unless an object depends on them.
+ *          If the index can not be built, all the objects are probed in
+ *          section order, the lazy ones included.
  */
 int object_init(void)
 {
+	object_init_pool_t *pool = &object_init_pool;
+	object_index_t *index = &object_index;
 	int level;
+	int ret = 0;
+	int err;
+
+	/* Fall back to the sequential probes if the index can not be built */
+	if (object_index_build()) {
+		for (level = 0; level < OBJECT_LEVELS_NUM; level += 2) {
+			err = object_do_one_initcall(level);
+			if (err)
+				return err;
+		}
+
+		return 0;
+	}
+
+	object_depends_bind();
+	object_lazy_start();
+	object_init_pool_start(pool);
+
+	for (level = 0; level < OBJECT_LEVELS_NUM / 2; level++) {
+		err = object_init_level(pool,
+					index->level_first[level],
+					index->level_first[level + 1]);
+		if (err && !ret)
+			ret = err;
+	}
+
+	object_init_pool_stop(pool);
+
+	return ret;
+}
+
+/**
+ * @brief   Get the probe result of an object.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns 0 if the object is probed, -EAGAIN if it is not probed
+ *          yet, -ECANCELED if a dependency failed, the probe error
+ *          otherwise. A lazy object not bound yet, or shut down when idle,
+ *          is not probed.
+ */
+int object_get_probe_status(const object *obj)
+{
+	int id;
+
+	if (!obj)
+		return -EINVAL;
+
+	id = object_get_handle_id(obj);
+	if (id < 0)
+		return id;
+
+	if (object_probe[id].state != OBJECT_PROBE_STATE_DONE)
+		return -EAGAIN;
+
+	return object_probe[id].status;
+}
+
+/**
+ * @brief   Release a reference taken by a binding.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ *
+ * @note    Only the bindings of lazy objects hold a reference, releasing
+ *          an other object does nothing.
+ */
+int object_put(const object *obj)
+{
+	int id;
+
+	if (!obj)
+		return -EINVAL;
+
+	if (!(obj->flags & OBJECT_FLAG_LAZY))
+		return 0;
+
+	id = object_get_handle_id(obj);
+	if (id < 0)
+		return id;
+
+	object_lazy_lock();
+
+	if (!object_probe[id].refs) {
+		object_lazy_unlock();
+		return -EPERM;
+	}
+
+	if (!--object_probe[id].refs)
+		object_lazy_idle(id);
+
+	object_lazy_unlock();
+
+	return 0;
+}
+
+/**
+ * @brief   Get the number of references held on an object.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns the number of references, 0 for an object which is not
+ *          lazy, negative error code otherwise.
+ */
+int object_get_ref_num(const object *obj)
+{
+	int id;
+
+	if (!obj)
+		return -EINVAL;
+
+	id = object_get_handle_id(obj);
+	if (id < 0)
+		return id;
+
+	return (int)object_probe[id].refs;
+}
+
+/**
+ * @brief   Check whether an object is probed, for the power callbacks.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns 1 if the object is probed, 0 otherwise.
+ */
+static int object_is_active(const object *obj)
+{
+	int id;
+
+	if (!(obj->flags & OBJECT_FLAG_LAZY))
+		return 1;
+
+	id = object_get_handle_id(obj);
+	if (id < 0)
+		return 1;
+
+	return object_probe[id].state == OBJECT_PROBE_STATE_DONE &&
+	       !object_probe[id].status;
+}
+
+/**
+ * @brief   Shut down an object and release the lazy objects it holds.
+ *
+ * @param   obj Pointer to the object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int object_shutdown_call(const object *obj)
+{
 	int ret;
+	int id;
 
-	for (level = 0; level < OBJECT_LEVELS_NUM; level += 2) {
-		ret = object_do_one_initcall(level);
-		if (ret)
-			return ret;
+	ret = obj->shutdown ? obj->shutdown(obj) : 0;
+	if (ret)
+		return ret;
+
+	id = object_get_handle_id(obj);
+	if (id < 0)
+		return 0;
+
+	object_lazy_lock();
+
+	if (object_is_lazy(id)) {
+		object_lazy_busy(id);
+		object_probe[id].state = OBJECT_PROBE_STATE_NONE;
 	}
 
+	object_depends_release(id);
+
+	object_lazy_unlock();
+
 	return 0;
 }
 
@@ -119,8 +1232,8 @@ static int object_do_one_deinitcall(int level)
 
 	for (obj = object_levels[level]; obj < object_levels[level + 1];
 	     obj++) {
-		if (obj && obj->shutdown) {
-			ret = obj->shutdown(obj);
+		if (obj && object_is_active(obj)) {
+			ret = object_shutdown_call(obj);
 			if (ret)
 				return ret;
 		}
@@ -165,7 +1278,7 @@ static int object_do_one_suspendcall(int level, int suspend_level)
 
 	for (obj = object_levels[level]; obj < object_levels[level + 1];
 	     obj++) {
-		if (obj && obj->suspend) {
+		if (obj && obj->suspend && object_is_active(obj)) {
 			ret = obj->suspend(obj, suspend_level);
 			if (ret)
 				return ret;
@@ -211,7 +1324,7 @@ static int object_do_one_resumecall(int level, int resume_level)
 
 	for (obj = object_levels[level]; obj < object_levels[level + 1];
 	     obj++) {
-		if (obj && obj->resume) {
+		if (obj && obj->resume && object_is_active(obj)) {
 			ret = obj->resume(obj, resume_level);
 			if (ret)
 				return ret;
@@ -242,12 +1355,75 @@ int object_resume(int resume_level)
 	return 0;
 }
 
+/**
+ * @brief   Get the object ID.
+ *
+ * @param   name Object name.
+ *
+ * @retval  Returns the object ID on success, negative error code otherwise.
+ *
+ * @note    The ID is stable for a given image, resolve it once and use
+ *          object_get_binding_by_id() on the hot path.
+ */
+int object_get_id(const char *const name)
+{
+	object_index_t *index = &object_index;
+	unsigned int slot;
+	int id;
+	int ret;
+
+	if (!name)
+		return -EINVAL;
+
+	ret = object_index_build();
+	if (ret)
+		return ret;
+
+	slot = object_hash_name(name) & OBJECT_INDEX_HASH_MASK;
+	while ((id = index->hash[slot]) != OBJECT_INDEX_EMPTY) {
+		if (!strcmp(name, index->table[id]->name))
+			return id;
+		slot = (slot + 1) & OBJECT_INDEX_HASH_MASK;
+	}
+
+	return -ENODEV;
+}
+
+/**
+ * @brief   Get the object handle by ID.
+ *
+ * @param   id Object ID.
+ *
+ * @retval  Object handle for reference or NULL in case of error.
+ *
+ * @note    A lazy object is probed by its first binding, and each binding
+ *          takes a reference, see object_put().
+ */
+const object *object_get_binding_by_id(int id)
+{
+	object_index_t *index = &object_index;
+
+	if (index->state != OBJECT_INDEX_STATE_READY)
+		return NULL;
+
+	if (id < 0 || id >= index->num)
+		return NULL;
+
+	if (object_is_lazy(id) && object_lazy_hold(id))
+		return NULL;
+
+	return index->table[id];
+}
+
 /**
  * @brief   Get the object handle.
  *
  * @param   name Object name.
  *
  * @retval  Object handle for reference or NULL in case of error.
+ *
+ * @note    A lazy object is probed by its first binding, and each binding
+ *          takes a reference, see object_put().
  */
 const object *object_get_binding(const char *const name)
 {
@@ -255,6 +1431,13 @@ const object *object_get_binding(const char *const name)
 	object *obj;
 	object *start;
 	object *end;
+	int id;
+
+	id = object_get_id(name);
+	if (id >= 0)
+		return object_get_binding_by_id(id);
+	else if (id != -ENOMEM)
+		return NULL;
 
 	for (level = 0; level < OBJECT_LEVELS_NUM; level += 2) {
 		start = object_levels[level];
@@ -16,22 +16,42 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdio.h>
 #include <string.h>
 #include "cmsis_os2.h"
 #include "object.h"
 #include "err.h"
 #include "log.h"
 #include "message.h"
+#include "flight_recorder.h"
+#include "boot_profile.h"
+#include "cycle_counter.h"
 #include "service.h"
 
 static int service_init_default(const object *		obj,
 				const service_config_t *config);
 static int service_deinit_default(const object *obj);
 static int service_send_message_default(const object *			obj,
-					const service_message_t *	service_message);
+					const service_message_t *	service_message,
+					service_overflow_t		overflow);
 static void service_handle_message_default(const object *		obj,
 					   const service_message_t *	service_message);
+static void service_handle_messages_default(const object *		obj,
+					    const service_message_t *	service_message,
+					    unsigned int		num);
 static void service_routine_thread(void *argument);
+static void service_ready_expect(void);
+static void service_ready_signal(service_t *svc);
+static void service_ready_cancel(service_t *svc);
+static void service_message_release(const service_message_t *service_message);
+static int service_send_rsp_lane(const service_t *	dst,
+				 const service_t *	src,
+				 const message_t *	message,
+				 service_lane_t		lane);
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+static int service_edf_drop_oldest(const service_t *	svc,
+				   service_message_t *	service_message);
+#endif
 
 const service_config_t service_config_default = {
 	.thread_attr		=
@@ -53,6 +73,16 @@ const service_config_t service_config_default = {
 		.cb_size	= 0,
 		.mq_mem		= NULL,
 		.mq_size	= 0,
+	},
+
+	.urgent_queue_attr	=
+	{
+		.name		= CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_NAME,
+		.attr_bits	= 0,
+		.cb_mem		= NULL,
+		.cb_size	= 0,
+		.mq_mem		= NULL,
+		.mq_size	= 0,
 	}
 };
 
@@ -61,8 +91,306 @@ const service_intf_t service_intf_default = {
 	.deinit		= service_deinit_default,
 	.send_message	= service_send_message_default,
 	.handle_message = service_handle_message_default,
+	.handle_messages = service_handle_messages_default,
 };
 
+#define SERVICE_SEND_TIMEOUT_TICKS \
+	(CONFIG_MSG_SEND_BLOCK_TIMEOUT_MS * osKernelGetTickFreq() / 1000)
+
+#define SERVICE_BITMAP_WORDS ((CONFIG_SERVICE_MAX_NUM + 31) / 32)
+
+/**
+ * @brief   Subscribers of a broadcast message ID.
+ *
+ * @note    Bit N of the bitmap is the N-th service in section "module_service".
+ */
+typedef struct {
+	unsigned int	id;
+	unsigned int	bitmap[SERVICE_BITMAP_WORDS];
+} service_subscriber_t;
+
+/**
+ * @brief   Subscriber table, the entries are sorted by message ID.
+ */
+typedef struct {
+	service_subscriber_t	entry[CONFIG_SERVICE_SUBSCRIPTION_MAX_NUM];
+	unsigned int		entry_num;
+	unsigned int		wildcard[SERVICE_BITMAP_WORDS];
+} service_subscriber_table_t;
+
+static service_subscriber_table_t service_subscriber_table;
+
+/**
+ * @brief   Completion slot of a synchronous call.
+ */
+typedef enum {
+	SERVICE_CALL_FREE,
+	SERVICE_CALL_PENDING,
+	SERVICE_CALL_DONE,
+	SERVICE_CALL_DROPPED,
+	SERVICE_CALL_ABANDONED
+} service_call_state_t;
+
+typedef struct {
+	service_call_state_t	state;
+	osThreadId_t		caller;
+	message_t		rsp_message;
+} service_call_t;
+
+static service_call_t service_call_slots[CONFIG_SERVICE_CALL_SLOT_NUM];
+
+extern service_t module_service$$Base[];
+extern service_t module_service$$Limit[];
+
+/**
+ * @brief   Get the index of the service in the service section.
+ *
+ * @param   svc Pointer to the service handle, may be NULL.
+ *
+ * @retval  Returns the index, FLIGHT_RECORD_NO_SERVICE for NULL.
+ */
+static unsigned int service_get_index(const service_t *svc)
+{
+	if (!svc)
+		return FLIGHT_RECORD_NO_SERVICE;
+
+	return svc - module_service$$Base;
+}
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+/**
+ * @brief   Service statistics manager.
+ */
+typedef struct {
+	osThreadId_t	thread_id;
+	uint32_t	cycles_per_us;
+} service_stats_manager_t;
+
+static service_stats_manager_t service_stats_manager;
+
+/**
+ * @brief   Get the current timestamp.
+ *
+ * @param   None.
+ *
+ * @retval  Returns the timestamp in cycles.
+ */
+static uint32_t service_stats_timestamp(void)
+{
+	return cycle_counter_read();
+}
+
+/**
+ * @brief   Convert a duration to the histogram bucket.
+ *
+ * @param   cycles Duration in cycles.
+ * @param   us Pointer to the duration in microseconds.
+ *
+ * @retval  Returns the bucket index.
+ */
+static unsigned int service_stats_bucket(uint32_t cycles, uint32_t *us)
+{
+	uint32_t cycles_per_us = service_stats_manager.cycles_per_us;
+	unsigned int bucket;
+
+	*us = cycles / (cycles_per_us ? cycles_per_us : 1);
+	if (!*us)
+		return 0;
+
+	bucket = 32 - __CLZ(*us);
+	if (bucket >= CONFIG_SERVICE_STATS_HIST_NUM)
+		bucket = CONFIG_SERVICE_STATS_HIST_NUM - 1;
+
+	return bucket;
+}
+
+/**
+ * @brief   Account a message put into the queue.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   ret Result of the put.
+ *
+ * @retval  None.
+ */
+static void service_stats_enqueue(const service_t *svc, int ret)
+{
+	service_stats_t *stats = &((service_t *)svc)->stats;
+	uint32_t depth;
+	int32_t lock;
+
+	/* Senders may preempt each other, the read-modify-write is locked */
+	lock = osKernelLock();
+
+	if (ret) {
+		stats->drop_num++;
+	} else {
+		depth = osMessageQueueGetCount(svc->queue_id)
+			+ osMessageQueueGetCount(svc->urgent_queue_id);
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+		depth += svc->edf.num;
+#endif
+		if (depth > stats->queue_high_water)
+			stats->queue_high_water = depth;
+	}
+
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Account the queue wait of a received message.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the received message.
+ *
+ * @note    Only called by the thread running the service.
+ *
+ * @retval  None.
+ */
+static void service_stats_wait(const service_t *		svc,
+			       const service_message_t *	service_message)
+{
+	service_stats_t *stats = &((service_t *)svc)->stats;
+	unsigned int bucket;
+	uint32_t us;
+
+	bucket = service_stats_bucket(
+		service_stats_timestamp() - service_message->enqueue_time,
+		&us);
+
+	stats->wait_hist[bucket]++;
+	if (us > stats->wait_max_us)
+		stats->wait_max_us = us;
+}
+
+/**
+ * @brief   Account a run of the message handler.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   start Timestamp before the handler was called.
+ * @param   num Number of the handled messages.
+ *
+ * @note    Only called by the thread running the service.
+ *
+ * @retval  None.
+ */
+static void service_stats_run(const service_t *	svc,
+			      uint32_t		start,
+			      unsigned int	num)
+{
+	service_stats_t *stats = &((service_t *)svc)->stats;
+	unsigned int bucket;
+	uint32_t us;
+
+	bucket = service_stats_bucket(service_stats_timestamp() - start, &us);
+
+	stats->run_hist[bucket]++;
+	if (us > stats->run_max_us)
+		stats->run_max_us = us;
+
+	stats->handled_num += num;
+}
+#endif
+
+/**
+ * @brief   Set up the queue discipline of the normal lane.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   config Pointer to the configuration space.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_discipline_init(service_t *			svc,
+				   const service_config_t *	config)
+{
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	uint32_t length;
+#endif
+
+	switch (config->discipline) {
+	case SERVICE_DISCIPLINE_FIFO:
+		return 0;
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	case SERVICE_DISCIPLINE_EDF:
+
+		length = config->queue_length ? config->queue_length :
+			 CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH;
+
+		/* Every queued message may be moved into the heap */
+		if (!config->edf_mem || config->edf_size < length) {
+			pr_error("Service <%s> has no deadline heap.",
+				 svc->name);
+			return -EINVAL;
+		}
+
+		(void)memset(&svc->edf, 0, sizeof(service_edf_t));
+		svc->edf.entry = config->edf_mem;
+		svc->edf.size = config->edf_size;
+		svc->edf.drop_late = config->edf_drop_late;
+
+		svc->edf.credit_id = osSemaphoreNew(length, length, NULL);
+		if (!svc->edf.credit_id) {
+			pr_error("Service <%s> create deadline credits failed.",
+				 svc->name);
+			return -ENOMEM;
+		}
+
+		return 0;
+#endif
+
+	default:
+		pr_error("Service <%s> discipline %d is not supported.",
+			 svc->name,
+			 config->discipline);
+		return -ENOSUPPORT;
+	}
+}
+
+/**
+ * @brief   Create the message queues of both lanes.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   config Pointer to the configuration space.
+ * @param   length Length of the normal lane.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_create_queues(service_t *			svc,
+				 const service_config_t *	config,
+				 uint32_t			length)
+{
+	svc->queue_id = osMessageQueueNew(length,
+					  sizeof(service_message_t),
+					  &config->queue_attr);
+	if (!svc->queue_id) {
+		pr_error("Service <%s> create message queue <%s> failed.",
+			 svc->name,
+			 config->queue_attr.name);
+		return -EINVAL;
+	} else {
+		pr_info("Service <%s> create message queue <%s> succeed.",
+			svc->name,
+			config->queue_attr.name);
+	}
+
+	svc->urgent_queue_id =
+		osMessageQueueNew(CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_LENGTH,
+				  sizeof(service_message_t),
+				  &config->urgent_queue_attr);
+	if (!svc->urgent_queue_id) {
+		pr_error("Service <%s> create message queue <%s> failed.",
+			 svc->name,
+			 config->urgent_queue_attr.name);
+		return -EINVAL;
+	} else {
+		pr_info("Service <%s> create message queue <%s> succeed.",
+			svc->name,
+			config->urgent_queue_attr.name);
+	}
+
+	return 0;
+}
+
 /**
  * @brief   Initialize the service instance.
  *
@@ -75,38 +403,67 @@ static int service_init_default(const object *		obj,
 				const service_config_t *config)
 {
 	service_t *svc = (service_t *)obj->object_data;
+	uint32_t begin;
 	int ret;
 
+	if (svc->isr_ring) {
+		ret = mpsc_ring_init(svc->isr_ring,
+				     svc->isr_ring->buffer,
+				     svc->isr_ring->size,
+				     sizeof(message_t));
+		if (ret) {
+			pr_error("Service <%s> initialize isr ring failed.",
+				 svc->name);
+			return ret;
+		}
+	}
+
+	ret = service_discipline_init(svc, config);
+	if (ret)
+		return ret;
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	if (svc->inline_queue) {
+		svc->inline_queue->buffer =
+			xMessageBufferCreate(svc->inline_queue->size);
+		if (!svc->inline_queue->buffer) {
+			pr_error("Service <%s> create inline queue failed.",
+				 svc->name);
+			return -ENOMEM;
+		}
+	}
+#endif
+
+	begin = boot_profile_begin();
 	svc->thread_id = osThreadNew(service_routine_thread,
 				     (void *)obj,
 				     &config->thread_attr);
+	boot_profile_end(BOOT_PROFILE_THREAD_CREATE, svc->name, begin);
 	if (!svc->thread_id) {
 		pr_error("Service <%s> create thread <%s> failed.",
 			 svc->name,
 			 config->thread_attr.name);
 		return -EINVAL;
 	} else {
+		service_ready_expect();
 		pr_info("Service <%s> create thread <%s> succeed.",
 			svc->name,
 			config->thread_attr.name);
 	}
 
-	svc->queue_id = osMessageQueueNew(CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH,
-					  sizeof(service_message_t),
-					  &config->queue_attr);
-	if (!svc->queue_id) {
-		pr_error("Service <%s> create message queue <%s> failed.",
-			 svc->name,
-			 config->queue_attr.name);
-		return -EINVAL;
-	} else {
-		pr_info("Service <%s> create message queue <%s> succeed.",
-			svc->name,
-			config->queue_attr.name);
-	}
+	begin = boot_profile_begin();
+	ret = service_create_queues(svc,
+				    config,
+				    config->queue_length ? config->queue_length :
+				    CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+	boot_profile_end(BOOT_PROFILE_QUEUE_CREATE, svc->name, begin);
+	if (ret)
+		return ret;
 
 	if (svc->init) {
+		begin = boot_profile_begin();
 		ret = svc->init(svc, svc->priv);
+		boot_profile_end(BOOT_PROFILE_SERVICE_INIT, svc->name, begin);
 		if (ret)
 			return ret;
 	}
@@ -138,6 +495,8 @@ static int service_deinit_default(const object *obj)
 			pr_info("Service <%s> terminate thread <%s> succeed.",
 				svc->name,
 				osThreadGetName(svc->thread_id));
+
+		service_ready_cancel(svc);
 	}
 
 	if (svc->queue_id) {
@@ -150,6 +509,30 @@ static int service_deinit_default(const object *obj)
 				svc->name);
 	}
 
+	if (svc->urgent_queue_id) {
+		stat = osMessageQueueDelete(svc->urgent_queue_id);
+		if (stat != osOK)
+			pr_error("Service <%s> delete urgent message queue failed.",
+				 svc->name);
+		else
+			pr_info("Service <%s> delete urgent message queue succeed.",
+				svc->name);
+	}
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	if (svc->edf.credit_id) {
+		(void)osSemaphoreDelete(svc->edf.credit_id);
+		svc->edf.credit_id = NULL;
+	}
+#endif
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	if (svc->inline_queue && svc->inline_queue->buffer) {
+		vMessageBufferDelete(svc->inline_queue->buffer);
+		svc->inline_queue->buffer = NULL;
+	}
+#endif
+
 	if (svc->deinit)
 		svc->deinit(svc, svc->priv);
 
@@ -159,226 +542,389 @@ static int service_deinit_default(const object *obj)
 }
 
 /**
- * @brief   Sends a message to service.
+ * @brief   Check whether the message belongs to the coalescing group.
  *
- * @param   obj Pointer to the service object handle.
- * @param   service_message Service message to send.
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the service message.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @retval  Returns 1 if the message can be coalesced, 0 otherwise.
  */
-static int service_send_message_default(const object *			obj,
-					const service_message_t *	service_message)
+static int service_coalesce_match(const service_t *		svc,
+				  const service_message_t *	service_message)
 {
-	service_t *svc = (service_t *)obj->object_data;
-	osMessageQueueId_t queue_id = svc->queue_id;
-	osStatus_t stat;
+	const service_coalesce_t *coalesce = svc->coalesce;
+	unsigned int i;
 
-	stat =
-		osMessageQueuePut(queue_id,
-				  service_message,
-				  sizeof(service_message_t),
-				  CONFIG_MSG_SEND_BLOCK_TIMEOUT_MS * osKernelGetTickFreq() /
-				  1000);
-	if (stat != osOK)
-		return -EPIPE;
+	if (!coalesce)
+		return 0;
+
+	if (service_message->type != MSG_TYPE_EVT
+	    || service_message->lane != SERVICE_LANE_NORMAL)
+		return 0;
+
+	/* The payload references are never merged */
+	if (message_payload_is_valid(service_message->msg.ptr))
+		return 0;
+
+	for (i = 0; i < coalesce->id_num; i++)
+		if (coalesce->id[i] == service_message->msg.id)
+			return 1;
 
 	return 0;
 }
 
 /**
- * @brief   Handle service message queue.
+ * @brief   Replace the pending message with the same key, or reserve a slot.
  *
- * @param   obj Pointer to the service object handle.
- * @param   service_message Pointer to the service message structure.
+ * @param   coalesce Pointer to the coalescing group.
+ * @param   message Pointer to the message.
+ * @param   reserved Pointer to the reserved slot, NULL if the table is full.
  *
- * @retval  None.
+ * @retval  Returns 0 if the pending message was replaced, -ENOENT if the
+ *          message must be queued.
  */
-static void service_handle_message_default(const object *		obj,
-					   const service_message_t *	service_message)
+static int service_coalesce_update(service_coalesce_t *		coalesce,
+				   const message_t *		message,
+				   service_coalesce_slot_t **	reserved)
 {
-	service_t *svc = (service_t *)obj->object_data;
-	message_t rsp_message;
-	int ret;
+	service_coalesce_slot_t *slot;
+	unsigned int i;
+	int32_t lock;
 
-	if (svc->handle_message)
-		svc->handle_message(&service_message->msg,
-				    &rsp_message,
-				    svc->priv);
+	*reserved = NULL;
 
-	if (service_message->type == MSG_TYPE_REQ) {
-		ret = service_send_rsp(service_message->src,
-				       service_message->dst,
-				       &rsp_message);
-		if (ret) {
-			pr_error(
-				"Service <%s> responds to service <%s> messsage 0x%x failed, ret %d.",
-				service_message->dst->name,
-				service_message->src->name,
-				service_message->msg.id,
-				ret);
+	lock = osKernelLock();
+
+	for (i = 0; i < CONFIG_SERVICE_COALESCE_SLOT_NUM; i++) {
+		slot = &coalesce->slot[i];
+
+		if (slot->pending && slot->msg.param0 == message->param0) {
+			slot->msg = *message;
+			slot->merged++;
+			coalesce->coalesced_num++;
+			(void)osKernelRestoreLock(lock);
+			return 0;
 		}
+
+		if (!slot->pending && !*reserved)
+			*reserved = slot;
+	}
+
+	/* The queued message becomes the token of the key */
+	if (*reserved) {
+		(*reserved)->pending = 1;
+		(*reserved)->merged = 0;
+		(*reserved)->msg = *message;
 	}
+
+	(void)osKernelRestoreLock(lock);
+
+	return -ENOENT;
 }
 
 /**
- * @brief   service routine thread, processing message loops.
+ * @brief   Release a reserved slot whose token could not be queued.
  *
- * @param   argument Pointer to the service object handle.
+ * @note    The events replaced in place meanwhile were acknowledged to their
+ *          senders, the slot is kept for them.
  *
- * @retval  None.
+ * @param   slot Pointer to the slot.
+ *
+ * @retval  Returns 0 if the slot was released, -EBUSY if it is kept.
  */
-static void service_routine_thread(void *argument)
+static int service_coalesce_cancel(service_coalesce_slot_t *slot)
 {
-	object *obj = (object *)argument;
-	service_t *svc = (service_t *)obj->object_data;
-	service_intf_t *intf = (service_intf_t *)obj->object_intf;
-	service_message_t service_message;
-	osStatus_t stat;
+	int32_t lock;
+	int ret = -EBUSY;
 
-	while (1) {
-		stat = osMessageQueueGet(svc->queue_id,
-					 &service_message,
-					 NULL,
-					 osWaitForever);
-		if (stat != osOK)
-			continue;
+	lock = osKernelLock();
 
-		if (intf->handle_message)
-			intf->handle_message(obj, &service_message);
+	if (!slot->merged) {
+		slot->pending = 0;
+		ret = 0;
 	}
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
 }
 
 /**
- * @brief   Probe the service object.
+ * @brief   Release a kept slot and count the acknowledged events it loses.
  *
- * @param   obj Pointer to the service object handle.
+ * @param   coalesce Pointer to the coalescing group.
+ * @param   slot Pointer to the slot.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @retval  None.
  */
-int service_probe(const object *obj)
+static void service_coalesce_drop(service_coalesce_t *		coalesce,
+				  service_coalesce_slot_t *	slot)
 {
-	service_t *svc = (service_t *)obj->object_data;
-	service_config_t *config = (service_config_t *)obj->object_config;
-	service_intf_t *intf = (service_intf_t *)obj->object_intf;
-	int ret;
-
-	svc->owner = obj;
-
-	if (intf->init) {
-		ret = intf->init(obj, config);
-		if (ret)
-			return ret;
-	}
-
-	pr_info("Object <%s> probe succeed.", obj->name);
+	int32_t lock;
 
-	return 0;
+	lock = osKernelLock();
+	coalesce->drop_num += slot->merged;
+	slot->pending = 0;
+	(void)osKernelRestoreLock(lock);
 }
 
 /**
- * @brief   Remove the service object.
+ * @brief   Replace a received token with the latest message of its key.
  *
- * @param   obj Pointer to the service object handle.
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the received message.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @retval  None.
+ *
+ * @note    Only the token tagged with the slot consumes it. A message of
+ *          the same key queued without a slot, because the table was full,
+ *          keeps its own data.
  */
-int service_shutdown(const object *obj)
+static void service_coalesce_take(const service_t *	svc,
+				  service_message_t *	service_message)
 {
-	service_intf_t *intf = (service_intf_t *)obj->object_intf;
-	int ret;
+	service_coalesce_slot_t *slot;
+	int32_t lock;
 
-	if (intf->deinit) {
-		ret = intf->deinit(obj);
-		if (ret)
-			return ret;
+	if (!svc->coalesce || !service_message->coalesce_slot)
+		return;
+
+	slot = &svc->coalesce->slot[service_message->coalesce_slot - 1];
+
+	lock = osKernelLock();
+
+	if (slot->pending) {
+		service_message->msg = slot->msg;
+		slot->pending = 0;
 	}
 
-	pr_info("Object <%s> shutdown succeed.", obj->name);
+	(void)osKernelRestoreLock(lock);
 
-	return 0;
+	service_message->coalesce_slot = 0;
 }
 
-extern service_t module_service$$Base[];
-extern service_t module_service$$Limit[];
-
 /**
- * @brief   Get the service handle.
+ * @brief   Fail a synchronous call whose request was dropped.
  *
- * @param   name Service name.
+ * @param   call Pointer to the call slot.
  *
- * @retval  Service handle for reference or NULL in case of error.
+ * @retval  None.
  */
-const service_t *service_get_binding(const char *const name)
+static void service_call_drop(service_call_t *call)
 {
-	const service_t *start = module_service$$Base;
-	const service_t *end = module_service$$Limit;
-	const service_t *svc;
+	osThreadId_t caller = NULL;
+	int32_t lock;
 
-	for (svc = start; svc < end; svc++)
-		if (svc && !strcmp(name, svc->name))
-			return svc;
+	lock = osKernelLock();
 
-	return NULL;
-}
+	if (call->state == SERVICE_CALL_PENDING) {
+		call->state = SERVICE_CALL_DROPPED;
+		caller = call->caller;
+	} else {
+		call->state = SERVICE_CALL_FREE;
+	}
 
-/**
- * @brief   Get the owner for service.
- *
- * @param   svc Pointer to the service handle.
- *
- * @retval  Returns the owner.
- */
-const object *service_get_owner(const service_t *svc)
-{
-	return svc->owner;
+	(void)osKernelRestoreLock(lock);
+
+	if (caller)
+		(void)osThreadFlagsSet(caller, SERVICE_FLAG_CALL);
 }
 
 /**
- * @brief   Get the name for service.
+ * @brief   Count an overflow of the queue.
  *
  * @param   svc Pointer to the service handle.
+ * @param   overflow The policy which handled the overflow.
  *
- * @retval  Returns the name.
+ * @retval  None.
  */
-const char *service_get_name(const service_t *svc)
+static void service_overflow_count(const service_t *	svc,
+				   service_overflow_t	overflow)
 {
-	return svc->name;
+	int32_t lock;
+
+	lock = osKernelLock();
+	((service_t *)svc)->overflow_num[overflow]++;
+	(void)osKernelRestoreLock(lock);
 }
 
 /**
- * @brief   Get the thread ID for service.
+ * @brief   Discard the oldest message of the queue to make room.
  *
  * @param   svc Pointer to the service handle.
+ * @param   queue_id The queue of the lane.
  *
- * @retval  Returns the thread ID.
+ * @retval  Returns 0 on success, -EEMPTY if the queue was drained meanwhile.
  */
-osThreadId_t service_get_thread_id(const service_t *svc)
+static int service_queue_drop_oldest(const service_t *		svc,
+				     osMessageQueueId_t		queue_id)
 {
-	return svc->thread_id;
+	service_message_t service_message;
+	int ret = -EEMPTY;
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	/* The heap holds the oldest messages of the normal lane */
+	if (svc->edf.entry && queue_id == svc->queue_id)
+		ret = service_edf_drop_oldest(svc, &service_message);
+#endif
+
+	if (ret && osMessageQueueGet(queue_id,
+				     &service_message,
+				     NULL,
+				     0) == osOK)
+		ret = 0;
+
+	if (ret)
+		return ret;
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	if (svc->edf.credit_id && queue_id == svc->queue_id)
+		(void)osSemaphoreRelease(svc->edf.credit_id);
+#endif
+
+	/* Free the coalescing slot the dropped message stands for */
+	service_coalesce_take(svc, &service_message);
+
+	if (service_message.call)
+		service_call_drop(service_message.call);
+
+	service_message_release(&service_message);
+
+	return 0;
 }
 
 /**
- * @brief   Get the queue ID for service.
+ * @brief   Put a message into a queue of the service.
  *
  * @param   svc Pointer to the service handle.
+ * @param   queue_id The queue of the lane.
+ * @param   service_message Service message to put.
+ * @param   timeout Timeout in ticks to wait for room.
  *
- * @retval  Returns the queue ID.
+ * @retval  Returns osOK on success, the status of the RTOS otherwise.
+ *
+ * @note    The normal lane of a deadline service is full once the heap and
+ *          the queue together hold its length, its credits are checked
+ *          first, the queue then always has room.
  */
-osMessageQueueId_t service_get_queue_id(const service_t *svc)
+static osStatus_t service_lane_put(const service_t *		svc,
+				   osMessageQueueId_t		queue_id,
+				   const service_message_t *	service_message,
+				   uint32_t			timeout)
 {
-	return svc->queue_id;
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	osStatus_t stat;
+
+	if (svc->edf.credit_id && queue_id == svc->queue_id) {
+		stat = osSemaphoreAcquire(svc->edf.credit_id, timeout);
+		if (stat != osOK)
+			return stat;
+
+		stat = osMessageQueuePut(queue_id,
+					 service_message,
+					 sizeof(service_message_t),
+					 0);
+		if (stat != osOK)
+			(void)osSemaphoreRelease(svc->edf.credit_id);
+
+		return stat;
+	}
+#endif
+
+	return osMessageQueuePut(queue_id,
+				 service_message,
+				 sizeof(service_message_t),
+				 timeout);
 }
 
 /**
- * @brief   Get the private data for service.
+ * @brief   Put a message into the queue of its lane.
  *
  * @param   svc Pointer to the service handle.
+ * @param   service_message Service message to send.
+ * @param   overflow What to do if the queue is full.
  *
- * @retval  Returns the private data.
+ * @retval  Returns 0 on success, negative error code otherwise.
  */
-void *service_get_private_data(const service_t *svc)
+static int service_queue_put(const service_t *		svc,
+			     const service_message_t *	service_message,
+			     service_overflow_t		overflow)
 {
-	return svc->priv;
+	osMessageQueueId_t queue_id = svc->queue_id;
+	service_coalesce_slot_t *slot = NULL;
+	service_message_t queued = *service_message;
+	uint32_t timeout = 0;
+	osStatus_t stat;
+	int ret = 0;
+
+	if (overflow == SERVICE_OVERFLOW_DEFAULT)
+		overflow = svc->overflow;
+
+	if (overflow == SERVICE_OVERFLOW_DEFAULT
+	    || overflow >= SERVICE_OVERFLOW_NUM)
+		overflow = SERVICE_OVERFLOW_BLOCK;
+
+	/* A caller would wait for the response of a dropped request */
+	if (overflow == SERVICE_OVERFLOW_DROP_NEWEST && service_message->call)
+		overflow = SERVICE_OVERFLOW_FAIL;
+
+	if (overflow == SERVICE_OVERFLOW_BLOCK)
+		timeout = SERVICE_SEND_TIMEOUT_TICKS;
+
+	if (service_coalesce_match(svc, service_message)
+	    && !service_coalesce_update(svc->coalesce,
+					&service_message->msg,
+					&slot))
+		return 0;
+
+	/* Tag the token, only it may consume the slot */
+	queued.coalesce_slot = slot ? slot - svc->coalesce->slot + 1 : 0;
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	queued.enqueue_time = service_stats_timestamp();
+#endif
+	service_message = &queued;
+
+	if (service_message->lane == SERVICE_LANE_URGENT)
+		queue_id = svc->urgent_queue_id;
+
+	stat = service_lane_put(svc, queue_id, service_message, timeout);
+
+	if (stat != osOK) {
+		service_overflow_count(svc, overflow);
+
+		/* Put once more, the receiver may also have made room */
+		if (overflow == SERVICE_OVERFLOW_DROP_OLDEST) {
+			(void)service_queue_drop_oldest(svc, queue_id);
+			stat = service_lane_put(svc, queue_id,
+						service_message, 0);
+		}
+	}
+
+	/*
+	 * The events coalesced meanwhile only live in the slot, queue the token
+	 * once more for them before giving up
+	 */
+	if (stat != osOK && slot && service_coalesce_cancel(slot)) {
+		stat = service_lane_put(svc, queue_id, service_message, 0);
+		if (stat != osOK)
+			service_coalesce_drop(svc->coalesce, slot);
+	}
+
+	if (stat != osOK)
+		ret = -EPIPE;
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	service_stats_enqueue(svc, ret);
+#endif
+
+	/* The new message is discarded silently */
+	if (ret && overflow == SERVICE_OVERFLOW_DROP_NEWEST) {
+		service_message_release(service_message);
+		ret = 0;
+	}
+
+	return ret;
 }
 
 /**
@@ -386,164 +932,2516 @@ void *service_get_private_data(const service_t *svc)
  *
  * @param   obj Pointer to the service object handle.
  * @param   service_message Service message to send.
+ * @param   overflow What to do if the queue is full.
  *
  * @retval  Returns 0 on success, negative error code otherwise.
  */
-static int service_send_message(const object *			obj,
-				const service_message_t *	service_message)
+static int service_send_message_default(const object *			obj,
+					const service_message_t *	service_message,
+					service_overflow_t		overflow)
 {
-	service_intf_t *intf = (service_intf_t *)obj->object_intf;
+	service_t *svc = (service_t *)obj->object_data;
+	int ret;
 
-	if (!obj)
-		return -EINVAL;
+	ret = service_queue_put(svc, service_message, overflow);
+	if (ret)
+		return ret;
 
-	if ((intf == NULL)
-	    || (intf->send_message == NULL))
-		return -ENOSUPPORT;
+	/* Wake up the routine thread, it waits on both lanes */
+	(void)osThreadFlagsSet(svc->thread_id, SERVICE_FLAG_MESSAGE);
 
-	return intf->send_message(obj, service_message);
+	return 0;
 }
 
 /**
- * @brief   Sends a event message to service.
+ * @brief   Complete a synchronous call and wake up the caller.
  *
- * @param   dst Pointer to the destination service handle.
- * @param   message Message structure to send.
+ * @param   call Pointer to the call slot.
+ * @param   rsp_message Pointer to the respond message from the handler.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @note    The payload reference of the handler is handed over to the
+ *          caller, or dropped if the caller has given up.
+ *
+ * @retval  None.
  */
-int service_send_evt(const service_t *dst, const message_t *message)
+static void service_call_complete(service_call_t *	call,
+				  const message_t *	rsp_message)
 {
-	service_message_t service_message;
-	const object *obj;
+	osThreadId_t caller = NULL;
+	int32_t lock;
 
-	if (!dst)
-		return -EINVAL;
+	lock = osKernelLock();
 
-	if (!message)
-		return -EINVAL;
+	if (call->state == SERVICE_CALL_PENDING) {
+		call->rsp_message = *rsp_message;
+		call->state = SERVICE_CALL_DONE;
+		caller = call->caller;
+	} else {
+		call->state = SERVICE_CALL_FREE;
+	}
 
-	obj = service_get_owner(dst);
-	if (!obj)
-		return -EINVAL;
+	(void)osKernelRestoreLock(lock);
 
-	service_message.dst = dst;
-	service_message.src = NULL;
-	service_message.type = MSG_TYPE_EVT;
-	memcpy(&service_message.msg, message, sizeof(message_t));
+	if (caller)
+		(void)osThreadFlagsSet(caller, SERVICE_FLAG_CALL);
+	else if (message_payload_is_valid(rsp_message->ptr))
+		(void)message_payload_put(rsp_message->ptr);
+}
 
-	//pr_info("Send event 0x%x to service <%s>.",
-	//	message->id,
-	//	dst->name);
+/**
+ * @brief   Send the response if the message is a request.
+ *
+ * @param   service_message Pointer to the service message structure.
+ * @param   rsp_message Pointer to the respond message from the handler.
+ *
+ * @retval  None.
+ */
+static void service_respond(const service_message_t *	service_message,
+			    const message_t *		rsp_message)
+{
+	int ret;
+
+	if (service_message->type != MSG_TYPE_REQ)
+		return;
+
+	if (service_message->call) {
+		service_call_complete(service_message->call, rsp_message);
+		return;
+	}
+
+	ret = service_send_rsp_lane(service_message->src,
+				    service_message->dst,
+				    rsp_message,
+				    (service_lane_t)service_message->lane);
+	if (ret) {
+		pr_error(
+			"Service <%s> responds to service <%s> messsage 0x%x failed, ret %d.",
+			service_message->dst->name,
+			service_message->src->name,
+			service_message->msg.id,
+			ret);
+	}
 
-	return service_send_message(obj, &service_message);
+	/* The response took its own reference, drop the handler's one. */
+	if (message_payload_is_valid(rsp_message->ptr))
+		(void)message_payload_put(rsp_message->ptr);
 }
 
 /**
- * @brief   Sends a request message to service.
+ * @brief   Search the dispatch tables for the handler of a message ID.
  *
- * @param   dst Pointer to the destination service handle.
- * @param   src Pointer to the source service handle.
- * @param   message Message structure to send.
+ * @param   svc Pointer to the service handle.
+ * @param   id Message ID.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @retval  Handler of the ID, or NULL if the tables have none.
  */
-int service_send_req(const service_t *	dst,
-		     const service_t *	src,
-		     const message_t *	message)
+static service_handler_fn_t service_handler_search(const service_t *	svc,
+						   unsigned int		id)
 {
-	service_message_t service_message;
-	const object *obj;
+	const service_handler_table_t *table;
+	unsigned int index = MSG_ID_GET_INDEX(id);
+	unsigned int i;
 
-	if (!dst)
-		return -EINVAL;
+	for (i = 0; i < svc->dispatch_num; i++) {
+		table = &svc->dispatch[i];
 
-	if (!src)
-		return -EINVAL;
+		/* The ID check also rejects the IDs of the other groups */
+		if (index < table->entry_num && table->entry[index].id == id)
+			return table->entry[index].handler;
+	}
 
-	if (!message)
-		return -EINVAL;
+	return NULL;
+}
 
-	obj = service_get_owner(dst);
-	if (!obj)
-		return -EINVAL;
+/**
+ * @brief   Handle service message queue.
+ *
+ * @param   obj Pointer to the service object handle.
+ * @param   service_message Pointer to the service message structure.
+ *
+ * @retval  None.
+ */
+static void service_handle_message_default(const object *		obj,
+					   const service_message_t *	service_message)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_handler_fn_t handler;
+	message_t rsp_message;
 
-	service_message.dst = dst;
-	service_message.src = src;
-	service_message.type = MSG_TYPE_REQ;
-	memcpy(&service_message.msg, message, sizeof(message_t));
+	(void)memset(&rsp_message, 0, sizeof(rsp_message));
 
-	//pr_info("Send request 0x%x from service <%s> to service <%s>.",
-	//	message->id,
-	//	src->name,
-	//	dst->name);
+	handler = service_handler_search(svc, service_message->msg.id);
+	if (handler)
+		handler(&service_message->msg, &rsp_message, svc->priv);
+	else if (svc->handle_message)
+		svc->handle_message(&service_message->msg,
+				    &rsp_message,
+				    svc->priv);
 
-	return service_send_message(obj, &service_message);
+	service_respond(service_message, &rsp_message);
 }
 
 /**
- * @brief	Sends a respond message to service.
+ * @brief   Handle a batch of service messages.
  *
- * @param   dst Pointer to the destination service handle.
- * @param   src Pointer to the source service handle.
- * @param   message Message structure to send.
+ * @param   obj Pointer to the service object handle.
+ * @param   service_message Pointer to the service message array.
+ * @param   num Number of the messages.
  *
- * @retval	Returns 0 on success, negative error code otherwise.
+ * @retval  None.
  */
-int service_send_rsp(const service_t *	dst,
-		     const service_t *	src,
-		     const message_t *	message)
+static void service_handle_messages_default(const object *		obj,
+					    const service_message_t *	service_message,
+					    unsigned int		num)
 {
-	service_message_t service_message;
-	const object *obj;
-
-	if (!dst)
-		return -EINVAL;
+	service_t *svc = (service_t *)obj->object_data;
+	message_t message[CONFIG_SERVICE_BATCH_MAX_NUM];
+	message_t rsp_message[CONFIG_SERVICE_BATCH_MAX_NUM];
+	unsigned int i;
+
+	if (!svc->handle_messages) {
+		for (i = 0; i < num; i++)
+			service_handle_message_default(obj, &service_message[i]);
+		return;
+	}
 
-	if (!src)
-		return -EINVAL;
+	if (num > CONFIG_SERVICE_BATCH_MAX_NUM)
+		num = CONFIG_SERVICE_BATCH_MAX_NUM;
 
-	if (!message)
-		return -EINVAL;
+	for (i = 0; i < num; i++)
+		message[i] = service_message[i].msg;
 
-	obj = service_get_owner(dst);
-	if (!obj)
-		return -EINVAL;
+	(void)memset(rsp_message, 0, sizeof(message_t) * num);
 
-	service_message.dst = dst;
-	service_message.src = src;
-	service_message.type = MSG_TYPE_RSP;
-	memcpy(&service_message.msg, message, sizeof(message_t));
+	svc->handle_messages(message, rsp_message, num, svc->priv);
 
-	//pr_info("Send respond 0x%x from service <%s> to service <%s>.",
-	//		message->id,
-	//		src->name,
-	//		dst->name);
+	for (i = 0; i < num; i++)
+		service_respond(&service_message[i], &rsp_message[i]);
+}
 
-	return service_send_message(obj, &service_message);
+/**
+ * @brief   Release the resources held by a service message.
+ *
+ * @param   service_message Pointer to the service message structure.
+ *
+ * @retval  None.
+ */
+static void service_message_release(const service_message_t *service_message)
+{
+	if (message_payload_is_valid(service_message->msg.ptr))
+		(void)message_payload_put(service_message->msg.ptr);
 }
 
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
 /**
- * @brief	Broadcast event messages to all services.
+ * @brief   Check whether an entry must be served before another one.
  *
- * @param   message Message structure to send.
+ * @param   a Pointer to the first entry.
+ * @param   b Pointer to the second entry.
  *
- * @retval  Returns 0 on success, negative error code otherwise.
+ * @retval  Returns 1 if a comes first, 0 otherwise.
  */
-int service_broadcast_evt(const message_t *message)
+static int service_edf_before(const service_edf_entry_t *	a,
+			      const service_edf_entry_t *	b)
 {
-	const service_t *start = module_service$$Base;
-	const service_t *end = module_service$$Limit;
-	const service_t *svc;
+	uint32_t a_deadline = a->service_message.deadline;
+	uint32_t b_deadline = b->service_message.deadline;
+
+	/* The messages without a deadline come last */
+	if (a_deadline != b_deadline) {
+		if (!a_deadline)
+			return 0;
+		if (!b_deadline)
+			return 1;
+		return (int32_t)(a_deadline - b_deadline) < 0;
+	}
 
-	if (!message)
-		return -EINVAL;
+	return (int32_t)(a->seq - b->seq) < 0;
+}
+
+/**
+ * @brief   Move an entry up the deadline heap from a free position.
+ *
+ * @param   edf Pointer to the deadline runtime.
+ * @param   pos The free position.
+ * @param   entry Pointer to the entry to place.
+ *
+ * @retval  None.
+ */
+static void service_edf_sift_up(service_edf_t *			edf,
+				unsigned int			pos,
+				const service_edf_entry_t *	entry)
+{
+	unsigned int parent;
+
+	while (pos) {
+		parent = (pos - 1) / 2;
+		if (!service_edf_before(entry, &edf->entry[parent]))
+			break;
+
+		edf->entry[pos] = edf->entry[parent];
+		pos = parent;
+	}
+
+	edf->entry[pos] = *entry;
+}
+
+/**
+ * @brief   Move an entry down the deadline heap from a free position.
+ *
+ * @param   edf Pointer to the deadline runtime.
+ * @param   pos The free position.
+ * @param   entry Pointer to the entry to place.
+ *
+ * @retval  None.
+ */
+static void service_edf_sift_down(service_edf_t *		edf,
+				  unsigned int			pos,
+				  const service_edf_entry_t *	entry)
+{
+	unsigned int child;
+
+	while ((child = pos * 2 + 1) < edf->num) {
+		if (child + 1 < edf->num
+		    && service_edf_before(&edf->entry[child + 1],
+					  &edf->entry[child]))
+			child++;
+
+		if (!service_edf_before(&edf->entry[child], entry))
+			break;
+
+		edf->entry[pos] = edf->entry[child];
+		pos = child;
+	}
+
+	edf->entry[pos] = *entry;
+}
+
+/**
+ * @brief   Push a message into the deadline heap.
+ *
+ * @param   edf Pointer to the deadline runtime.
+ * @param   service_message Pointer to the message.
+ *
+ * @note    Called with the kernel locked, the senders drop from the heap.
+ *
+ * @retval  None.
+ */
+static void service_edf_push(service_edf_t *			edf,
+			     const service_message_t *		service_message)
+{
+	service_edf_entry_t entry;
+
+	entry.service_message = *service_message;
+	entry.seq = edf->seq++;
+
+	service_edf_sift_up(edf, edf->num++, &entry);
+}
+
+/**
+ * @brief   Remove a message from the deadline heap.
+ *
+ * @param   edf Pointer to the deadline runtime, must not be empty.
+ * @param   pos Position of the message.
+ * @param   service_message Pointer to the message.
+ *
+ * @note    Called with the kernel locked, the senders drop from the heap.
+ *
+ * @retval  None.
+ */
+static void service_edf_remove(service_edf_t *		edf,
+			       unsigned int		pos,
+			       service_message_t *	service_message)
+{
+	service_edf_entry_t last;
+
+	*service_message = edf->entry[pos].service_message;
+
+	last = edf->entry[--edf->num];
+	if (pos == edf->num)
+		return;
+
+	if (pos && service_edf_before(&last, &edf->entry[(pos - 1) / 2]))
+		service_edf_sift_up(edf, pos, &last);
+	else
+		service_edf_sift_down(edf, pos, &last);
+}
+
+/**
+ * @brief   Discard the oldest message of the normal lane from the heap.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the discarded message.
+ *
+ * @note    The heap holds the messages received before the queued ones.
+ *          The head of the queue takes the freed entry, so that the queue
+ *          gets the room.
+ *
+ * @retval  Returns 0 on success, -EEMPTY if the heap is empty.
+ */
+static int service_edf_drop_oldest(const service_t *	svc,
+				   service_message_t *	service_message)
+{
+	service_edf_t *edf = &((service_t *)svc)->edf;
+	service_message_t queued;
+	unsigned int oldest = 0;
+	unsigned int i;
+	int32_t lock;
+
+	lock = osKernelLock();
+
+	if (!edf->num) {
+		(void)osKernelRestoreLock(lock);
+		return -EEMPTY;
+	}
+
+	for (i = 1; i < edf->num; i++)
+		if ((int32_t)(edf->entry[i].seq - edf->entry[oldest].seq) < 0)
+			oldest = i;
+
+	service_edf_remove(edf, oldest, service_message);
+
+	if (osMessageQueueGet(svc->queue_id, &queued, NULL, 0) == osOK)
+		service_edf_push(edf, &queued);
+
+	(void)osKernelRestoreLock(lock);
+
+	return 0;
+}
+
+/**
+ * @brief   Receive the normal lane message with the earliest deadline.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the received message.
+ *
+ * @note    Only called by the thread running the service.
+ *
+ * @retval  Returns 0 on success, -EEMPTY if the lane is empty.
+ */
+static int service_edf_receive(const service_t *	svc,
+			       service_message_t *	service_message)
+{
+	service_edf_t *edf = &((service_t *)svc)->edf;
+	service_message_t queued;
+	int32_t lock;
+
+	/* Move the queued messages into the heap, in arrival order */
+	lock = osKernelLock();
+
+	while (edf->num < edf->size) {
+		if (osMessageQueueGet(svc->queue_id, &queued, NULL, 0) != osOK)
+			break;
+
+		service_edf_push(edf, &queued);
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	for (;;) {
+		lock = osKernelLock();
+
+		if (!edf->num) {
+			(void)osKernelRestoreLock(lock);
+			break;
+		}
+
+		service_edf_remove(edf, 0, service_message);
+
+		(void)osKernelRestoreLock(lock);
+
+		(void)osSemaphoreRelease(edf->credit_id);
+
+		service_coalesce_take(svc, service_message);
+
+		if (!service_message->deadline
+		    || (int32_t)(osKernelGetTickCount() -
+				 service_message->deadline) <= 0)
+			return 0;
+
+		edf->late_num++;
+		if (!edf->drop_late)
+			return 0;
+
+		if (service_message->call)
+			service_call_drop(service_message->call);
+
+		service_message_release(service_message);
+	}
+
+	return -EEMPTY;
+}
+#endif
+
+/**
+ * @brief   Receive a message, the urgent lane is always served first.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the received message.
+ *
+ * @retval  Returns 0 on success, -EEMPTY if both lanes are empty.
+ */
+static int service_receive_message(const service_t *	svc,
+				   service_message_t *	service_message)
+{
+	osStatus_t stat;
+
+	stat = osMessageQueueGet(svc->urgent_queue_id,
+				 service_message,
+				 NULL,
+				 0);
+	if (stat == osOK)
+		return 0;
+
+	/* Events from interrupt handlers come before the bulk traffic */
+	if (svc->isr_ring && !mpsc_ring_read(svc->isr_ring,
+					     &service_message->msg)) {
+		service_message->dst = svc;
+		service_message->src = NULL;
+		service_message->type = MSG_TYPE_EVT;
+		service_message->lane = SERVICE_LANE_URGENT;
+		service_message->call = NULL;
+		service_message->deadline = 0;
+		service_message->coalesce_slot = 0;
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+		/* The ring keeps no timestamp, its wait is not measured */
+		service_message->enqueue_time = service_stats_timestamp();
+#endif
+		return 0;
+	}
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	if (svc->edf.entry)
+		return service_edf_receive(svc, service_message);
+#endif
+
+	stat = osMessageQueueGet(svc->queue_id,
+				 service_message,
+				 NULL,
+				 0);
+	if (stat == osOK) {
+		service_coalesce_take(svc, service_message);
+		return 0;
+	}
+
+	return -EEMPTY;
+}
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief   Receive an event from the inline queue.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   service_message Pointer to the received message.
+ *
+ * @note    Only called by the thread running the service. The payload is
+ *          read into the record of the queue and handled in place, so the
+ *          record holds one event at a time.
+ *
+ * @retval  Returns 0 on success, -EEMPTY if the queue is empty.
+ */
+static int service_inline_receive(const service_t *	svc,
+				  service_message_t *	service_message)
+{
+	service_inline_queue_t *inline_queue = svc->inline_queue;
+	size_t len;
+
+	if (!inline_queue || !inline_queue->buffer)
+		return -EEMPTY;
+
+	len = xMessageBufferReceive(inline_queue->buffer,
+				    &inline_queue->record,
+				    sizeof(service_inline_record_t),
+				    0);
+	if (!len)
+		return -EEMPTY;
+
+	service_message->dst = svc;
+	service_message->src = NULL;
+	service_message->type = MSG_TYPE_EVT;
+	service_message->lane = SERVICE_LANE_NORMAL;
+	service_message->call = NULL;
+	service_message->deadline = 0;
+	service_message->msg = inline_queue->record.msg;
+	service_message->msg.ptr = &inline_queue->record.payload;
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	/* The buffer keeps no timestamp, its wait is not measured */
+	service_message->enqueue_time = service_stats_timestamp();
+#endif
+
+	return 0;
+}
+#endif
+
+/**
+ * @brief   Check whether the service has no pending message.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns 1 if all the lanes are empty, 0 otherwise.
+ */
+static int service_is_empty(const service_t *svc)
+{
+	return !osMessageQueueGetCount(svc->urgent_queue_id)
+	       && !osMessageQueueGetCount(svc->queue_id)
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+	       && !svc->edf.num
+#endif
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	       && (!svc->inline_queue || !svc->inline_queue->buffer
+		   || xMessageBufferIsEmpty(svc->inline_queue->buffer))
+#endif
+	       && (!svc->isr_ring || mpsc_ring_is_empty(svc->isr_ring));
+}
+
+/**
+ * @brief   Receive and handle one message, or one batch of messages.
+ *
+ * @param   obj Pointer to the service object handle.
+ *
+ * @retval  Returns 0 on success, -EEMPTY if there is no message.
+ */
+static int service_dispatch(const object *obj)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_intf_t *intf = (service_intf_t *)obj->object_intf;
+	service_message_t service_message[CONFIG_SERVICE_BATCH_MAX_NUM];
+	unsigned int num;
+	unsigned int i;
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	uint32_t start;
+#endif
+
+	/* At most one inline event per wakeup, it is held by the record */
+	if (service_receive_message(svc, &service_message[0])
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	    && service_inline_receive(svc, &service_message[0])
+#endif
+	    )
+		return -EEMPTY;
+
+	num = 1;
+
+	if (svc->handle_messages && intf->handle_messages) {
+		/* Drain the pending messages without waiting */
+		while (num < CONFIG_SERVICE_BATCH_MAX_NUM) {
+			if (service_receive_message(svc,
+						    &service_message[num]))
+				break;
+			num++;
+		}
+	}
+
+	for (i = 0; i < num; i++)
+		flight_recorder_record(FLIGHT_RECORD_DISPATCH,
+				       service_message[i].type,
+				       service_get_index(service_message[i].src),
+				       service_get_index(svc),
+				       &service_message[i].msg);
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	for (i = 0; i < num; i++)
+		service_stats_wait(svc, &service_message[i]);
+
+	start = service_stats_timestamp();
+#endif
+
+	if (svc->handle_messages && intf->handle_messages)
+		intf->handle_messages(obj, service_message, num);
+	else if (intf->handle_message)
+		intf->handle_message(obj, &service_message[0]);
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+	service_stats_run(svc, start, num);
+#endif
+
+	for (i = 0; i < num; i++)
+		service_message_release(&service_message[i]);
+
+	if (svc->on_idle && service_is_empty(svc))
+		svc->on_idle(svc->priv);
+
+	return 0;
+}
+
+/**
+ * @brief   Readiness barrier definitions.
+ *
+ * @note    Every service thread created is expected to report ready once it
+ *          enters its loop. The startup event is broadcast when all of them
+ *          did, instead of after a fixed delay.
+ */
+typedef struct {
+	unsigned int	expected;
+	unsigned int	ready;
+	osThreadId_t	waiter;
+} service_ready_barrier_t;
+
+static service_ready_barrier_t service_ready_barrier;
+
+/**
+ * @brief   Expect one more thread to report ready.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void service_ready_expect(void)
+{
+	service_ready_barrier_t *barrier = &service_ready_barrier;
+	int32_t lock;
+
+	lock = osKernelLock();
+	barrier->expected++;
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Wake up the waiter, if all the expected threads are ready.
+ *
+ * @param   barrier Pointer to the barrier.
+ *
+ * @retval  None.
+ *
+ * @note    It must be called with the kernel locked.
+ */
+static void service_ready_check(service_ready_barrier_t *barrier)
+{
+	if (barrier->waiter && barrier->ready >= barrier->expected) {
+		(void)osThreadFlagsSet(barrier->waiter, SERVICE_FLAG_READY);
+		barrier->waiter = NULL;
+	}
+}
+
+/**
+ * @brief   Report the calling thread ready.
+ *
+ * @param   svc Pointer to the service handle, NULL for a shared worker.
+ *
+ * @retval  None.
+ */
+static void service_ready_signal(service_t *svc)
+{
+	service_ready_barrier_t *barrier = &service_ready_barrier;
+	int32_t lock;
+
+	lock = osKernelLock();
+	if (svc)
+		svc->ready = 1;
+	barrier->ready++;
+	service_ready_check(barrier);
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Stop expecting a terminated thread which never reported ready.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  None.
+ */
+static void service_ready_cancel(service_t *svc)
+{
+	service_ready_barrier_t *barrier = &service_ready_barrier;
+	int32_t lock;
+
+	lock = osKernelLock();
+	if (!svc->ready && barrier->expected) {
+		barrier->expected--;
+		service_ready_check(barrier);
+	}
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Wait until all the service threads entered their loop.
+ *
+ * @param   timeout_ms Maximum time to wait, in milliseconds.
+ *
+ * @retval  Returns 0 on success, -ETIMEDOUT if some threads are not ready.
+ *
+ * @note    Only one thread may wait at a time, the init thread does it
+ *          before broadcasting MSG_ID_SYS_STARTUP_COMPLETED.
+ */
+int service_wait_ready(unsigned int timeout_ms)
+{
+	service_ready_barrier_t *barrier = &service_ready_barrier;
+	uint32_t flags;
+	int32_t lock;
+
+	(void)osThreadFlagsClear(SERVICE_FLAG_READY);
+
+	lock = osKernelLock();
+	if (barrier->ready >= barrier->expected) {
+		(void)osKernelRestoreLock(lock);
+		return 0;
+	}
+	barrier->waiter = osThreadGetId();
+	(void)osKernelRestoreLock(lock);
+
+	flags = osThreadFlagsWait(SERVICE_FLAG_READY,
+				  osFlagsWaitAny,
+				  timeout_ms * osKernelGetTickFreq() / 1000);
+
+	lock = osKernelLock();
+	barrier->waiter = NULL;
+	(void)osKernelRestoreLock(lock);
+
+	if (flags & osFlagsError) {
+		pr_error("Services ready %u/%u, wait timeout.",
+			 barrier->ready,
+			 barrier->expected);
+		return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief   service routine thread, processing message loops.
+ *
+ * @param   argument Pointer to the service object handle.
+ *
+ * @retval  None.
+ */
+static void service_routine_thread(void *argument)
+{
+	object *obj = (object *)argument;
+
+	service_ready_signal((service_t *)obj->object_data);
+
+	while (1) {
+		if (service_dispatch(obj))
+			(void)osThreadFlagsWait(SERVICE_FLAG_MESSAGE,
+						osFlagsWaitAny,
+						osWaitForever);
+	}
+}
+
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+
+static int service_init_actor(const object *		obj,
+			      const service_config_t *	config);
+static int service_send_message_actor(const object *			obj,
+				      const service_message_t *	service_message,
+				      service_overflow_t		overflow);
+
+const service_config_t service_config_actor = {
+	.queue_attr		=
+	{
+		.name		= CONFIG_SERVICE_DEFAULT_QUEUE_NAME,
+		.attr_bits	= 0,
+		.cb_mem		= NULL,
+		.cb_size	= 0,
+		.mq_mem		= NULL,
+		.mq_size	= 0,
+	},
+
+	.urgent_queue_attr	=
+	{
+		.name		= CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_NAME,
+		.attr_bits	= 0,
+		.cb_mem		= NULL,
+		.cb_size	= 0,
+		.mq_mem		= NULL,
+		.mq_size	= 0,
+	}
+};
+
+const service_intf_t service_intf_actor = {
+	.init		= service_init_actor,
+	.deinit		= service_deinit_default,
+	.send_message	= service_send_message_actor,
+	.handle_message = service_handle_message_default,
+	.handle_messages = service_handle_messages_default,
+};
+
+/**
+ * @brief   Actor scheduler definitions.
+ *
+ * An actor with pending messages is put into the ready queue once, the
+ * scheduled flag of the actor tells whether it is already there. Each
+ * worker records the actor it runs and the service it waits for in
+ * service_call(), they are updated with the kernel locked.
+ */
+typedef struct {
+	osMessageQueueId_t	ready_queue_id;
+	osThreadId_t		worker_id[CONFIG_SERVICE_ACTOR_WORKER_NUM];
+	const service_t *	running[CONFIG_SERVICE_ACTOR_WORKER_NUM];
+	const service_t *	calling[CONFIG_SERVICE_ACTOR_WORKER_NUM];
+} service_actor_scheduler_t;
+
+static service_actor_scheduler_t service_actor_scheduler;
+
+static const osThreadAttr_t service_actor_worker_attr = {
+	.name		= CONFIG_SERVICE_ACTOR_WORKER_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_SERVICE_ACTOR_WORKER_STACK_SIZE,
+	.priority	= CONFIG_SERVICE_ACTOR_WORKER_PRIORITY,
+};
+
+/**
+ * @brief   Put the actor into the ready queue if it is not there.
+ *
+ * @param   obj Pointer to the service object handle.
+ *
+ * @retval  None.
+ */
+static void service_actor_schedule(const object *obj)
+{
+	service_actor_scheduler_t *scheduler = &service_actor_scheduler;
+	service_t *svc = (service_t *)obj->object_data;
+	unsigned int scheduled;
+	osStatus_t stat;
+	int32_t lock;
+
+	lock = osKernelLock();
+	scheduled = svc->scheduled;
+	svc->scheduled = 1;
+	(void)osKernelRestoreLock(lock);
+
+	if (scheduled)
+		return;
+
+	/* Never blocks, every actor is queued at most once */
+	stat = osMessageQueuePut(scheduler->ready_queue_id, &obj, 0, 0);
+	if (stat != osOK) {
+		svc->scheduled = 0;
+		pr_error("Service <%s> schedule failed, stat %d.",
+			 svc->name,
+			 stat);
+	}
+}
+
+/**
+ * @brief   Get the index of the current thread in the actor workers.
+ *
+ * @param   None.
+ *
+ * @retval  Returns the worker index, -1 if the thread is not a worker.
+ */
+static int service_actor_worker_index(void)
+{
+	service_actor_scheduler_t *scheduler = &service_actor_scheduler;
+	osThreadId_t thread_id = osThreadGetId();
+	int i;
+
+	for (i = 0; i < CONFIG_SERVICE_ACTOR_WORKER_NUM; i++)
+		if (scheduler->worker_id[i] == thread_id)
+			return i;
+
+	return -1;
+}
+
+/**
+ * @brief   Mark the call of an actor worker, unless it can never complete.
+ *
+ * @param   worker Index of the calling worker.
+ * @param   dst Pointer to the destination service handle.
+ *
+ * @retval  Returns 0 on success, -EDEADLK if dst is the calling actor or
+ *          is waiting, through a chain of calls, for the calling actor.
+ *
+ * @note    The calling actor stays scheduled while its worker waits, so
+ *          nobody else can run its requests.
+ */
+static int service_actor_call_enter(int worker, const service_t *dst)
+{
+	service_actor_scheduler_t *scheduler = &service_actor_scheduler;
+	const service_t *self = scheduler->running[worker];
+	const service_t *target = dst;
+	int32_t lock;
+	int ret = 0;
+	int hop;
+	int i;
+
+	lock = osKernelLock();
+
+	for (hop = 0; hop < CONFIG_SERVICE_ACTOR_WORKER_NUM; hop++) {
+		if (target == self) {
+			ret = -EDEADLK;
+			break;
+		}
+
+		/* Follow the call of the worker running the target */
+		for (i = 0; i < CONFIG_SERVICE_ACTOR_WORKER_NUM; i++)
+			if (scheduler->running[i] == target)
+				break;
+
+		if (i == CONFIG_SERVICE_ACTOR_WORKER_NUM
+		    || !scheduler->calling[i])
+			break;
+
+		target = scheduler->calling[i];
+	}
+
+	if (!ret)
+		scheduler->calling[worker] = dst;
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief   Clear the call of an actor worker.
+ *
+ * @param   worker Index of the calling worker.
+ *
+ * @retval  None.
+ */
+static void service_actor_call_exit(int worker)
+{
+	int32_t lock;
+
+	lock = osKernelLock();
+	service_actor_scheduler.calling[worker] = NULL;
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Initialize the actor instance, it has no thread of its own.
+ *
+ * @param   obj Pointer to the service object handle.
+ * @param   config Pointer to the configuration space.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_init_actor(const object *		obj,
+			      const service_config_t *	config)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	int ret;
+
+	if (!service_actor_scheduler.ready_queue_id) {
+		pr_error("Service <%s> has no actor scheduler.", svc->name);
+		return -ENODEV;
+	}
+
+	ret = service_discipline_init(svc, config);
+	if (ret)
+		return ret;
+
+	ret = service_create_queues(svc,
+				    config,
+				    config->queue_length ? config->queue_length :
+				    CONFIG_SERVICE_ACTOR_QUEUE_LENGTH);
+	if (ret)
+		return ret;
+
+	if (svc->init) {
+		ret = svc->init(svc, svc->priv);
+		if (ret)
+			return ret;
+	}
+
+	pr_info("Service <%s> initialize succeed.", svc->name);
+
+	return 0;
+}
+
+/**
+ * @brief   Sends a message to actor.
+ *
+ * @param   obj Pointer to the service object handle.
+ * @param   service_message Service message to send.
+ * @param   overflow What to do if the queue is full.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_send_message_actor(const object *			obj,
+				      const service_message_t *	service_message,
+				      service_overflow_t		overflow)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	int ret;
+
+	ret = service_queue_put(svc, service_message, overflow);
+	if (ret)
+		return ret;
+
+	service_actor_schedule(obj);
+
+	return 0;
+}
+
+/**
+ * @brief   Actor worker thread, runs the ready actors to completion.
+ *
+ * @param   argument Index of the worker.
+ *
+ * @retval  None.
+ */
+static void service_actor_worker_thread(void *argument)
+{
+	service_actor_scheduler_t *scheduler = &service_actor_scheduler;
+	int worker = (int)(intptr_t)argument;
+	const object *obj;
+	service_t *svc;
+	osStatus_t stat;
+	int32_t lock;
+	int budget;
+
+	service_ready_signal(NULL);
+
+	while (1) {
+		stat = osMessageQueueGet(scheduler->ready_queue_id,
+					 &obj,
+					 NULL,
+					 osWaitForever);
+		if (stat != osOK)
+			continue;
+
+		svc = (service_t *)obj->object_data;
+
+		lock = osKernelLock();
+		scheduler->running[worker] = svc;
+		(void)osKernelRestoreLock(lock);
+
+		/* Limit the turn, so one busy actor can not starve the others */
+		for (budget = 0; budget < CONFIG_SERVICE_ACTOR_BUDGET; budget++)
+			if (service_dispatch(obj))
+				break;
+
+		lock = osKernelLock();
+		scheduler->running[worker] = NULL;
+		svc->scheduled = 0;
+		(void)osKernelRestoreLock(lock);
+
+		/* A sender may have seen the flag set after the last dispatch */
+		if (!service_is_empty(svc))
+			service_actor_schedule(obj);
+	}
+}
+
+/**
+ * @brief   Probe the actor scheduler, create the ready queue and workers.
+ *
+ * @param   obj Pointer to the scheduler object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_actor_scheduler_probe(const object *obj)
+{
+	service_actor_scheduler_t *scheduler =
+		(service_actor_scheduler_t *)obj->object_data;
+	int i;
+
+	scheduler->ready_queue_id = osMessageQueueNew(CONFIG_SERVICE_MAX_NUM,
+						      sizeof(const object *),
+						      NULL);
+	if (!scheduler->ready_queue_id) {
+		pr_error("Object <%s> create ready queue failed.", obj->name);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < CONFIG_SERVICE_ACTOR_WORKER_NUM; i++) {
+		scheduler->worker_id[i] =
+			osThreadNew(service_actor_worker_thread,
+				    (void *)(intptr_t)i,
+				    &service_actor_worker_attr);
+		if (!scheduler->worker_id[i]) {
+			pr_error("Object <%s> create worker %d failed.",
+				 obj->name,
+				 i);
+			return -ENOMEM;
+		}
+
+		service_ready_expect();
+	}
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+module_service_manager(CONFIG_SERVICE_ACTOR_NAME,
+		       CONFIG_SERVICE_ACTOR_LABEL,
+		       service_actor_scheduler_probe,
+		       NULL,
+		       NULL,
+		       &service_actor_scheduler,
+		       NULL);
+
+#endif
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+static const osThreadAttr_t service_stats_thread_attr = {
+	.name		= CONFIG_SERVICE_STATS_THREAD_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_SERVICE_STATS_THREAD_STACK_SIZE,
+	.priority	= CONFIG_SERVICE_STATS_THREAD_PRIORITY,
+};
+
+/**
+ * @brief   Statistics thread, dump the statistics periodically.
+ *
+ * @param   argument Not used.
+ *
+ * @retval  None.
+ *
+ * @note    The dump formats a few lines per service, it runs here rather
+ *          than in the timer daemon, whose stack is too small for it and
+ *          which must not be held up by the trace output.
+ */
+static void service_stats_thread(void *argument)
+{
+	uint32_t period = CONFIG_SERVICE_STATS_DUMP_PERIOD_MS *
+			  osKernelGetTickFreq() / 1000;
+	uint32_t tick = osKernelGetTickCount();
+
+	(void)argument;
+
+	for (;;) {
+		tick += period;
+		(void)osDelayUntil(tick);
+		service_dump_stats();
+	}
+}
+
+/**
+ * @brief   Probe the statistics manager, start the cycle counter.
+ *
+ * @param   obj Pointer to the manager object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_stats_probe(const object *obj)
+{
+	service_stats_manager_t *manager =
+		(service_stats_manager_t *)obj->object_data;
+
+	cycle_counter_start();
+
+	manager->cycles_per_us = osKernelGetSysTimerFreq() / 1000000;
+
+	if (CONFIG_SERVICE_STATS_DUMP_PERIOD_MS) {
+		manager->thread_id = osThreadNew(service_stats_thread,
+						 NULL,
+						 &service_stats_thread_attr);
+		if (!manager->thread_id) {
+			pr_error("Object <%s> create thread failed.", obj->name);
+			return -ENOMEM;
+		}
+	}
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+module_service_manager(CONFIG_SERVICE_STATS_NAME,
+		       CONFIG_SERVICE_STATS_LABEL,
+		       service_stats_probe,
+		       NULL,
+		       NULL,
+		       &service_stats_manager,
+		       NULL);
+
+#endif
+
+/**
+ * @brief   Get the subscriber entry of a message ID.
+ *
+ * @param   id Message ID.
+ *
+ * @retval  Subscriber entry, or NULL if nobody subscribes the ID.
+ *
+ * @note    Must be called with the kernel locked.
+ */
+static service_subscriber_t *service_subscriber_search(unsigned int id)
+{
+	service_subscriber_table_t *table = &service_subscriber_table;
+	unsigned int low = 0;
+	unsigned int high = table->entry_num;
+	unsigned int mid;
+
+	while (low < high) {
+		mid = (low + high) / 2;
+
+		if (table->entry[mid].id == id)
+			return &table->entry[mid];
+		else if (table->entry[mid].id < id)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief   Add or get the subscriber entry of a message ID.
+ *
+ * @param   id Message ID.
+ *
+ * @retval  Subscriber entry, or NULL if the table is full.
+ *
+ * @note    Must be called with the kernel locked.
+ */
+static service_subscriber_t *service_subscriber_insert(unsigned int id)
+{
+	service_subscriber_table_t *table = &service_subscriber_table;
+	service_subscriber_t *entry;
+	unsigned int pos;
+
+	entry = service_subscriber_search(id);
+	if (entry)
+		return entry;
+
+	if (table->entry_num >= CONFIG_SERVICE_SUBSCRIPTION_MAX_NUM)
+		return NULL;
+
+	for (pos = table->entry_num; pos > 0; pos--) {
+		if (table->entry[pos - 1].id < id)
+			break;
+		table->entry[pos] = table->entry[pos - 1];
+	}
+
+	entry = &table->entry[pos];
+	(void)memset(entry, 0, sizeof(service_subscriber_t));
+	entry->id = id;
+	table->entry_num++;
+
+	return entry;
+}
+
+/**
+ * @brief   Subscribe the service to its broadcast message IDs.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_subscribe(const service_t *svc)
+{
+	service_subscriber_table_t *table = &service_subscriber_table;
+	service_subscriber_t *entry;
+	unsigned int index = svc - module_service$$Base;
+	unsigned int mask = 1u << (index % 32);
+	unsigned int i;
+	int32_t lock;
+	int ret = 0;
+
+	if (index >= CONFIG_SERVICE_MAX_NUM) {
+		pr_error("Service <%s> exceeds the max service number %d.",
+			 svc->name,
+			 CONFIG_SERVICE_MAX_NUM);
+		return -ENOMEM;
+	}
+
+	lock = osKernelLock();
+
+	if (!svc->subscription) {
+		table->wildcard[index / 32] |= mask;
+	} else {
+		for (i = 0; i < svc->subscription_num; i++) {
+			entry = service_subscriber_insert(svc->subscription[i]);
+			if (!entry) {
+				ret = -ENOMEM;
+				break;
+			}
+
+			entry->bitmap[index / 32] |= mask;
+		}
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	if (ret)
+		pr_error("Service <%s> subscribe failed, table is full.",
+			 svc->name);
+
+	return ret;
+}
+
+/**
+ * @brief   Remove the service from all the subscriber lists.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  None.
+ */
+static void service_unsubscribe(const service_t *svc)
+{
+	service_subscriber_table_t *table = &service_subscriber_table;
+	unsigned int index = svc - module_service$$Base;
+	unsigned int mask = 1u << (index % 32);
+	unsigned int i;
+	int32_t lock;
+
+	if (index >= CONFIG_SERVICE_MAX_NUM)
+		return;
+
+	lock = osKernelLock();
+
+	table->wildcard[index / 32] &= ~mask;
+
+	for (i = 0; i < table->entry_num; i++)
+		table->entry[i].bitmap[index / 32] &= ~mask;
+
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief   Check that every dispatch table holds the IDs of one group.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_dispatch_check(const service_t *svc)
+{
+	const service_handler_table_t *table;
+	unsigned int group;
+	unsigned int i;
+	unsigned int j;
+
+	for (i = 0; i < svc->dispatch_num; i++) {
+		table = &svc->dispatch[i];
+		group = 0;
+
+		for (j = 0; j < table->entry_num; j++) {
+			if (!table->entry[j].handler)
+				continue;
+
+			if (!group)
+				group = MSG_ID_GET_GROUP(table->entry[j].id);
+
+			if (MSG_ID_GET_GROUP(table->entry[j].id) != group) {
+				pr_error(
+					"Service <%s> dispatch table %d mixes message 0x%x and group 0x%x.",
+					svc->name,
+					i,
+					table->entry[j].id,
+					group);
+				return -EINVAL;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief   Probe the service object.
+ *
+ * @param   obj Pointer to the service object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_probe(const object *obj)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_config_t *config = (service_config_t *)obj->object_config;
+	service_intf_t *intf = (service_intf_t *)obj->object_intf;
+	int ret;
+
+	svc->owner = obj;
+
+	ret = service_dispatch_check(svc);
+	if (ret)
+		return ret;
+
+	if (intf->init) {
+		ret = intf->init(obj, config);
+		if (ret)
+			return ret;
+	}
+
+	ret = service_subscribe(svc);
+	if (ret)
+		return ret;
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+/**
+ * @brief   Remove the service object.
+ *
+ * @param   obj Pointer to the service object handle.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_shutdown(const object *obj)
+{
+	service_intf_t *intf = (service_intf_t *)obj->object_intf;
+	int ret;
+
+	service_unsubscribe((const service_t *)obj->object_data);
+
+	if (intf->deinit) {
+		ret = intf->deinit(obj);
+		if (ret)
+			return ret;
+	}
+
+	pr_info("Object <%s> shutdown succeed.", obj->name);
+
+	return 0;
+}
+
+/**
+ * @brief   Get the service handle.
+ *
+ * @param   name Service name.
+ *
+ * @retval  Service handle for reference or NULL in case of error.
+ */
+const service_t *service_get_binding(const char *const name)
+{
+	const service_t *start = module_service$$Base;
+	const service_t *end = module_service$$Limit;
+	const service_t *svc;
+	int id;
+
+	id = object_get_id(name);
+	if (id >= 0)
+		return service_get_binding_by_id(id);
+	else if (id != -ENOMEM)
+		return NULL;
+
+	for (svc = start; svc < end; svc++)
+		if (svc && !strcmp(name, svc->name))
+			return svc;
+
+	return NULL;
+}
+
+/**
+ * @brief   Get the service handle by object ID.
+ *
+ * @param   id Object ID, see object_get_id().
+ *
+ * @retval  Service handle for reference or NULL in case of error.
+ */
+const service_t *service_get_binding_by_id(int id)
+{
+	const service_t *start = module_service$$Base;
+	const service_t *end = module_service$$Limit;
+	const object *obj;
+	const service_t *svc;
+
+	obj = object_get_binding_by_id(id);
+	if (!obj)
+		return NULL;
+
+	/* Make sure the object is really a service */
+	svc = (const service_t *)obj->object_data;
+	if (svc < start || svc >= end)
+		return NULL;
+
+	return svc;
+}
+
+/**
+ * @brief   Get the service handle by its index in the service section.
+ *
+ * @param   index Service index.
+ *
+ * @retval  Service handle for reference or NULL in case of error.
+ */
+const service_t *service_get_binding_by_index(unsigned int index)
+{
+	if (index >= module_service$$Limit - module_service$$Base)
+		return NULL;
+
+	return &module_service$$Base[index];
+}
+
+/**
+ * @brief   Get the owner for service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the owner.
+ */
+const object *service_get_owner(const service_t *svc)
+{
+	return svc->owner;
+}
+
+/**
+ * @brief   Get the name for service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the name.
+ */
+const char *service_get_name(const service_t *svc)
+{
+	return svc->name;
+}
+
+/**
+ * @brief   Get the thread ID for service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the thread ID.
+ */
+osThreadId_t service_get_thread_id(const service_t *svc)
+{
+	return svc->thread_id;
+}
+
+/**
+ * @brief   Get the queue ID for service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the queue ID.
+ */
+osMessageQueueId_t service_get_queue_id(const service_t *svc)
+{
+	return svc->queue_id;
+}
+
+/**
+ * @brief   Get the number of messages queued on a lane.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   lane Lane to query.
+ *
+ * @retval  Returns the depth on success, negative error code otherwise.
+ */
+int service_get_lane_depth(const service_t *svc, service_lane_t lane)
+{
+	if (!svc)
+		return -EINVAL;
+
+	switch (lane) {
+	case SERVICE_LANE_NORMAL:
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+		/* The messages moved into the deadline heap are still pending */
+		return osMessageQueueGetCount(svc->queue_id) + svc->edf.num;
+#else
+		return osMessageQueueGetCount(svc->queue_id);
+#endif
+	case SERVICE_LANE_URGENT:
+		return osMessageQueueGetCount(svc->urgent_queue_id);
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief   Get the free space of a lane, the credit of the producers.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   lane The lane.
+ *
+ * @retval  Returns the number of free messages, negative error code otherwise.
+ */
+int service_queue_space(const service_t *svc, service_lane_t lane)
+{
+	if (!svc)
+		return -EINVAL;
+
+	switch (lane) {
+	case SERVICE_LANE_NORMAL:
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+		/* The heap and the queue share the credits of the lane */
+		if (svc->edf.credit_id)
+			return osSemaphoreGetCount(svc->edf.credit_id);
+#endif
+		return osMessageQueueGetSpace(svc->queue_id);
+	case SERVICE_LANE_URGENT:
+		return osMessageQueueGetSpace(svc->urgent_queue_id);
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief   Get the number of sends which found the queue full.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   overflow The policy which handled the overflow.
+ *
+ * @retval  Returns the number of overflows.
+ */
+unsigned int service_get_overflow_num(const service_t *	svc,
+				      service_overflow_t	overflow)
+{
+	if (!svc || overflow >= SERVICE_OVERFLOW_NUM)
+		return 0;
+
+	return svc->overflow_num[overflow];
+}
+
+/**
+ * @brief   Get the private data for service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the private data.
+ */
+void *service_get_private_data(const service_t *svc)
+{
+	return svc->priv;
+}
+
+/**
+ * @brief   Check if the service handles the message ID.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   id Message ID.
+ *
+ * @note    A service without dispatch tables, or with a catch-all
+ *          handle_message or batch handler, handles all the IDs.
+ *
+ * @retval  Returns 1 if the ID is handled, 0 otherwise.
+ */
+int service_is_handled(const service_t *svc, unsigned int id)
+{
+	if (!svc->dispatch || svc->handle_message || svc->handle_messages)
+		return 1;
+
+	return service_handler_search(svc, id) != NULL;
+}
+
+/**
+ * @brief   Sends a message to service.
+ *
+ * @param   obj Pointer to the service object handle.
+ * @param   service_message Service message to send.
+ * @param   overflow What to do if the queue is full.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_send_message(const object *			obj,
+				const service_message_t *	service_message,
+				service_overflow_t		overflow)
+{
+	service_intf_t *intf = (service_intf_t *)obj->object_intf;
+	const void *payload = service_message->msg.ptr;
+	int ret;
+
+	if (!obj)
+		return -EINVAL;
+
+	if ((intf == NULL)
+	    || (intf->send_message == NULL))
+		return -ENOSUPPORT;
+
+	/* Do not wake the service for a message it would drop */
+	if (service_message->type != MSG_TYPE_RSP
+	    && !service_is_handled(service_message->dst,
+				   service_message->msg.id))
+		return -ENOSUPPORT;
+
+	/* Every queued copy of the message holds a payload reference. */
+	if (message_payload_is_valid(payload)) {
+		ret = message_payload_get(payload);
+		if (ret)
+			return ret;
+	}
+
+	ret = intf->send_message(obj, service_message, overflow);
+	if (ret && message_payload_is_valid(payload))
+		(void)message_payload_put(payload);
+
+	flight_recorder_record(ret ? FLIGHT_RECORD_SEND_FAIL : FLIGHT_RECORD_SEND,
+			       service_message->type,
+			       service_get_index(service_message->src),
+			       service_get_index(service_message->dst),
+			       &service_message->msg);
+
+	return ret;
+}
+
+/**
+ * @brief   Get the lane from the send attributes.
+ *
+ * @param   attr Pointer to the send attributes, NULL for the default.
+ *
+ * @retval  Returns the lane on success, negative error code otherwise.
+ */
+static int service_send_attr_lane(const service_send_attr_t *attr)
+{
+	if (!attr)
+		return SERVICE_LANE_NORMAL;
+
+	if (attr->lane >= SERVICE_LANE_NUM)
+		return -EINVAL;
+
+	return attr->lane;
+}
+
+/**
+ * @brief   Get the overflow policy from the send attributes.
+ *
+ * @param   attr Pointer to the send attributes, NULL for the default.
+ *
+ * @retval  Returns the policy on success, negative error code otherwise.
+ */
+static int service_send_attr_overflow(const service_send_attr_t *attr)
+{
+	if (!attr)
+		return SERVICE_OVERFLOW_DEFAULT;
+
+	if (attr->overflow >= SERVICE_OVERFLOW_NUM)
+		return -EINVAL;
+
+	return attr->overflow;
+}
+
+/**
+ * @brief   Sends a event message to service.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_evt(const service_t *dst, const message_t *message)
+{
+	return service_send_evt_attr(dst, message, NULL);
+}
+
+/**
+ * @brief   Sends a event message to service with attributes.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send.
+ * @param   attr Pointer to the send attributes, NULL for the default.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_evt_attr(const service_t *		dst,
+			  const message_t *		message,
+			  const service_send_attr_t *	attr)
+{
+	service_message_t service_message;
+	const object *obj;
+	int overflow;
+	int lane;
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	lane = service_send_attr_lane(attr);
+	if (lane < 0)
+		return lane;
+
+	overflow = service_send_attr_overflow(attr);
+	if (overflow < 0)
+		return overflow;
+
+	obj = service_get_owner(dst);
+	if (!obj)
+		return -EINVAL;
+
+	service_message.dst = dst;
+	service_message.src = NULL;
+	service_message.type = MSG_TYPE_EVT;
+	service_message.lane = lane;
+	service_message.call = NULL;
+	service_message.deadline = attr ? attr->deadline : 0;
+	memcpy(&service_message.msg, message, sizeof(message_t));
+
+	//pr_info("Send event 0x%x to service <%s>.",
+	//	message->id,
+	//	dst->name);
+
+	return service_send_message(obj,
+				    &service_message,
+				    (service_overflow_t)overflow);
+}
+
+/**
+ * @brief   Sends a request message to service.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   src Pointer to the source service handle.
+ * @param   message Message structure to send.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_req(const service_t *	dst,
+		     const service_t *	src,
+		     const message_t *	message)
+{
+	return service_send_req_attr(dst, src, message, NULL);
+}
+
+/**
+ * @brief   Sends a request message to service with attributes.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   src Pointer to the source service handle.
+ * @param   message Message structure to send.
+ * @param   attr Pointer to the send attributes, NULL for the default.
+ *
+ * @note    The response is sent back on the same lane.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_req_attr(const service_t *		dst,
+			  const service_t *		src,
+			  const message_t *		message,
+			  const service_send_attr_t *	attr)
+{
+	service_message_t service_message;
+	const object *obj;
+	int overflow;
+	int lane;
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!src)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	lane = service_send_attr_lane(attr);
+	if (lane < 0)
+		return lane;
+
+	overflow = service_send_attr_overflow(attr);
+	if (overflow < 0)
+		return overflow;
+
+	obj = service_get_owner(dst);
+	if (!obj)
+		return -EINVAL;
+
+	service_message.dst = dst;
+	service_message.src = src;
+	service_message.type = MSG_TYPE_REQ;
+	service_message.lane = lane;
+	service_message.call = NULL;
+	service_message.deadline = attr ? attr->deadline : 0;
+	memcpy(&service_message.msg, message, sizeof(message_t));
+
+	//pr_info("Send request 0x%x from service <%s> to service <%s>.",
+	//	message->id,
+	//	src->name,
+	//	dst->name);
+
+	return service_send_message(obj,
+				    &service_message,
+				    (service_overflow_t)overflow);
+}
+
+/**
+ * @brief	Sends a respond message to service.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   src Pointer to the source service handle.
+ * @param   message Message structure to send.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int service_send_rsp(const service_t *	dst,
+		     const service_t *	src,
+		     const message_t *	message)
+{
+	return service_send_rsp_lane(dst, src, message, SERVICE_LANE_NORMAL);
+}
+
+/**
+ * @brief	Sends a respond message to service on the lane.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   src Pointer to the source service handle.
+ * @param   message Message structure to send.
+ * @param   lane Lane of the destination queue.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_send_rsp_lane(const service_t *	dst,
+				 const service_t *	src,
+				 const message_t *	message,
+				 service_lane_t		lane)
+{
+	service_message_t service_message;
+	const object *obj;
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!src)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	obj = service_get_owner(dst);
+	if (!obj)
+		return -EINVAL;
+
+	service_message.dst = dst;
+	service_message.src = src;
+	service_message.type = MSG_TYPE_RSP;
+	service_message.lane = lane;
+	service_message.call = NULL;
+	service_message.deadline = 0;
+	memcpy(&service_message.msg, message, sizeof(message_t));
+
+	//pr_info("Send respond 0x%x from service <%s> to service <%s>.",
+	//		message->id,
+	//		src->name,
+	//		dst->name);
+
+	return service_send_message(obj,
+				    &service_message,
+				    SERVICE_OVERFLOW_DEFAULT);
+}
+
+/**
+ * @brief   Send a call request and wait for the response.
+ *
+ * @param   obj Pointer to the destination service object handle.
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send.
+ * @param   rsp_message Pointer to the respond message.
+ * @param   timeout Timeout value in ticks, osWaitForever for no timeout.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int service_call_wait(const object *	obj,
+			     const service_t *	dst,
+			     const message_t *	message,
+			     message_t *	rsp_message,
+			     uint32_t		timeout)
+{
+	service_message_t service_message;
+	service_call_t *call = NULL;
+	int32_t lock;
+	int ret;
+	int i;
+
+	lock = osKernelLock();
+
+	for (i = 0; i < CONFIG_SERVICE_CALL_SLOT_NUM; i++) {
+		if (service_call_slots[i].state == SERVICE_CALL_FREE) {
+			call = &service_call_slots[i];
+			call->state = SERVICE_CALL_PENDING;
+			call->caller = osThreadGetId();
+			break;
+		}
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	if (!call)
+		return -EBUSY;
+
+	/* Discard a completion left by an earlier call */
+	(void)osThreadFlagsClear(SERVICE_FLAG_CALL);
+
+	service_message.dst = dst;
+	service_message.src = NULL;
+	service_message.type = MSG_TYPE_REQ;
+	service_message.lane = SERVICE_LANE_NORMAL;
+	service_message.call = call;
+	service_message.deadline = 0;
+	memcpy(&service_message.msg, message, sizeof(message_t));
+
+	ret = service_send_message(obj,
+				   &service_message,
+				   SERVICE_OVERFLOW_DEFAULT);
+	if (ret) {
+		call->state = SERVICE_CALL_FREE;
+		return ret;
+	}
+
+	(void)osThreadFlagsWait(SERVICE_FLAG_CALL, osFlagsWaitAny, timeout);
+
+	lock = osKernelLock();
+
+	if (call->state == SERVICE_CALL_DONE) {
+		*rsp_message = call->rsp_message;
+		call->state = SERVICE_CALL_FREE;
+		ret = 0;
+	} else if (call->state == SERVICE_CALL_DROPPED) {
+		/* The request was dropped from a full queue */
+		call->state = SERVICE_CALL_FREE;
+		ret = -EPIPE;
+	} else {
+		/* The slot is released when the late response arrives */
+		call->state = SERVICE_CALL_ABANDONED;
+		ret = -ETIMEDOUT;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief   Sends a request message to service and waits for the response.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send.
+ * @param   rsp_message Pointer to the respond message.
+ * @param   timeout Timeout value in ticks, osWaitForever for no timeout.
+ *
+ * @note    The response is passed back directly, it does not go through the
+ *          queue of the caller, so the caller needs not to be a service.
+ *          A payload in the response is owned by the caller.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_call(const service_t *	dst,
+		 const message_t *	message,
+		 message_t *		rsp_message,
+		 uint32_t		timeout)
+{
+	const object *obj;
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+	int worker;
+	int ret;
+#endif
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	if (!rsp_message)
+		return -EINVAL;
+
+	obj = service_get_owner(dst);
+	if (!obj)
+		return -EINVAL;
+
+	/* The service can not serve a call from its own routine thread */
+	if (dst->thread_id == osThreadGetId())
+		return -EDEADLK;
+
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+	worker = service_actor_worker_index();
+	if (worker < 0)
+		return service_call_wait(obj, dst, message, rsp_message, timeout);
+
+	/* Nobody is left to run the actor if the only worker waits */
+	if (!dst->thread_id && CONFIG_SERVICE_ACTOR_WORKER_NUM == 1)
+		return -EDEADLK;
+
+	ret = service_actor_call_enter(worker, dst);
+	if (ret)
+		return ret;
+
+	ret = service_call_wait(obj, dst, message, rsp_message, timeout);
+
+	service_actor_call_exit(worker);
+
+	return ret;
+#else
+	return service_call_wait(obj, dst, message, rsp_message, timeout);
+#endif
+}
+
+/**
+ * @brief	Broadcast event messages to the subscribed services.
+ *
+ * @param   message Message structure to send.
+ *
+ * @note    A payload from the message payload pool is shared by all the
+ *          receivers, the caller still owns its own reference.
+ *          The broadcast never blocks, if the queue of a subscriber is full
+ *          the message is dropped for this subscriber and counted.
+ *
+ * @retval  Returns 0 on success, -EPIPE if any subscriber dropped the message.
+ */
+int service_broadcast_evt(const message_t *message)
+{
+	service_subscriber_table_t *table = &service_subscriber_table;
+	const service_t *start = module_service$$Base;
+	const service_t *end = module_service$$Limit;
+	const service_subscriber_t *entry;
+	unsigned int bitmap[SERVICE_BITMAP_WORDS];
+	service_message_t service_message;
+	service_t *svc;
+	unsigned int index;
+	unsigned int word;
+	int32_t lock;
+	int ret = 0;
+
+	if (!message)
+		return -EINVAL;
 
 	//pr_info("Broadcast event 0x%x.", message->id);
 
-	for (svc = start; svc < end; svc++)
-		if (svc)
-			(void)service_send_evt(svc, message);
+	lock = osKernelLock();
+
+	entry = service_subscriber_search(message->id);
+	for (word = 0; word < SERVICE_BITMAP_WORDS; word++) {
+		bitmap[word] = table->wildcard[word];
+		if (entry)
+			bitmap[word] |= entry->bitmap[word];
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	service_message.src = NULL;
+	service_message.type = MSG_TYPE_EVT;
+	service_message.lane = SERVICE_LANE_NORMAL;
+	service_message.call = NULL;
+	service_message.deadline = 0;
+	memcpy(&service_message.msg, message, sizeof(message_t));
+
+	for (index = 0; index < CONFIG_SERVICE_MAX_NUM; index++) {
+		if (!(bitmap[index / 32] & (1u << (index % 32))))
+			continue;
+
+		svc = (service_t *)&start[index];
+		if (svc >= end)
+			break;
+
+		if (!service_is_handled(svc, message->id))
+			continue;
+
+		service_message.dst = svc;
+
+		/* A broadcast never waits for a slow receiver */
+		if (service_send_message(svc->owner,
+					 &service_message,
+					 SERVICE_OVERFLOW_FAIL)) {
+			lock = osKernelLock();
+			svc->broadcast_drop_num++;
+			(void)osKernelRestoreLock(lock);
+
+			ret = -EPIPE;
+		}
+	}
+
+	return ret;
+}
+
+/**
+ * @brief   Sends a event message to service from an interrupt handler.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send.
+ *
+ * @note    The service must be declared with SERVICE_ISR_RING(). The event is
+ *          copied into the lock-free ring of the service and the routine
+ *          thread is woken up when the interrupt returns. The interrupt
+ *          priority must allow FreeRTOS API calls. message->ptr must not
+ *          point to a payload from the message payload pool.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_evt_from_isr(const service_t *dst, const message_t *message)
+{
+	int ret;
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	/* Taking a payload reference is not allowed in interrupt context */
+	if (message_payload_is_valid(message->ptr))
+		return -EINVAL;
+
+	if (!dst->isr_ring || !dst->thread_id)
+		return -ENOSUPPORT;
+
+	if (!service_is_handled(dst, message->id))
+		return -ENOSUPPORT;
+
+	ret = mpsc_ring_write(dst->isr_ring, message);
+
+	flight_recorder_record(ret ? FLIGHT_RECORD_SEND_FAIL : FLIGHT_RECORD_SEND,
+			       MSG_TYPE_EVT,
+			       FLIGHT_RECORD_NO_SERVICE,
+			       service_get_index(dst),
+			       message);
+
+	if (ret)
+		return ret;
+
+	(void)osThreadFlagsSet(dst->thread_id, SERVICE_FLAG_MESSAGE);
+
+	return 0;
+}
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief   Sends a event message with an inline payload to service.
+ *
+ * @param   dst Pointer to the destination service handle.
+ * @param   message Message structure to send, message->ptr is ignored.
+ * @param   data Pointer to the payload, NULL if size is 0.
+ * @param   size Payload size in bytes.
+ *
+ * @note    The service must be declared with SERVICE_INLINE_QUEUE(). The
+ *          payload is copied into the message buffer of the service, the
+ *          handler gets message->ptr pointing to a message_inline_t. The
+ *          send never blocks, it fails if the buffer has no room. Not
+ *          allowed in interrupt context.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_send_evt_inline(const service_t *	dst,
+			    const message_t *	message,
+			    const void *	data,
+			    unsigned int	size)
+{
+	service_inline_queue_t *inline_queue;
+	service_inline_record_t record;
+	size_t len;
+	int32_t lock;
+	int ret = 0;
+
+	if (!dst)
+		return -EINVAL;
+
+	if (!message)
+		return -EINVAL;
+
+	if (size > CONFIG_SERVICE_INLINE_MAX_SIZE || (size && !data))
+		return -EINVAL;
+
+	inline_queue = dst->inline_queue;
+	if (!inline_queue || !inline_queue->buffer || !dst->thread_id)
+		return -ENOSUPPORT;
+
+	if (!service_is_handled(dst, message->id))
+		return -ENOSUPPORT;
+
+	record.msg = *message;
+	record.msg.ptr = NULL;
+	record.payload.size = size;
+	if (size)
+		memcpy(record.payload.data, data, size);
+
+	len = offsetof(service_inline_record_t, payload.data) + size;
+
+	/* A message buffer takes one writer at a time */
+	lock = osKernelLock();
+
+	if (xMessageBufferSend(inline_queue->buffer, &record, len, 0) != len) {
+		inline_queue->drop_num++;
+		ret = -EPIPE;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	flight_recorder_record(ret ? FLIGHT_RECORD_SEND_FAIL : FLIGHT_RECORD_SEND,
+			       MSG_TYPE_EVT,
+			       FLIGHT_RECORD_NO_SERVICE,
+			       service_get_index(dst),
+			       &record.msg);
+
+	if (ret)
+		return ret;
+
+	(void)osThreadFlagsSet(dst->thread_id, SERVICE_FLAG_MESSAGE);
+
+	return 0;
+}
+
+/**
+ * @brief   Get the number of inline events dropped by the service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of dropped events.
+ */
+unsigned int service_get_inline_drop_num(const service_t *svc)
+{
+	if (!svc->inline_queue)
+		return 0;
+
+	return svc->inline_queue->drop_num;
+}
+#endif
+
+/**
+ * @brief   Get the number of interrupt events dropped by the service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of dropped events.
+ */
+unsigned int service_get_isr_drop_num(const service_t *svc)
+{
+	if (!svc->isr_ring)
+		return 0;
+
+	return svc->isr_ring->drop_num;
+}
+
+/**
+ * @brief   Get the number of broadcast messages dropped by the service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of dropped messages.
+ */
+unsigned int service_get_broadcast_drop_num(const service_t *svc)
+{
+	return svc->broadcast_drop_num;
+}
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+/**
+ * @brief   Get the number of messages found past their deadline.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of late messages.
+ */
+unsigned int service_get_late_num(const service_t *svc)
+{
+	return svc->edf.late_num;
+}
+#endif
+
+/**
+ * @brief   Get the number of events replaced by a newer event of their key.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of coalesced events.
+ */
+unsigned int service_get_coalesce_num(const service_t *svc)
+{
+	if (!svc->coalesce)
+		return 0;
+
+	return svc->coalesce->coalesced_num;
+}
+
+/**
+ * @brief   Get the number of coalesced events lost with their token.
+ *
+ * @note    These events were acknowledged to their senders, then the token of
+ *          their key could not be queued.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @retval  Returns the number of lost events.
+ */
+unsigned int service_get_coalesce_drop_num(const service_t *svc)
+{
+	if (!svc->coalesce)
+		return 0;
+
+	return svc->coalesce->drop_num;
+}
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+/**
+ * @brief   Get the statistics of the service.
+ *
+ * @param   svc Pointer to the service handle.
+ * @param   stats Pointer to the statistics copy.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+int service_get_stats(const service_t *svc, service_stats_t *stats)
+{
+	int32_t lock;
+
+	if (!svc)
+		return -EINVAL;
+
+	if (!stats)
+		return -EINVAL;
+
+	lock = osKernelLock();
+	*stats = svc->stats;
+	(void)osKernelRestoreLock(lock);
 
 	return 0;
 }
+
+/**
+ * @brief   Clear the statistics of the service.
+ *
+ * @param   svc Pointer to the service handle.
+ *
+ * @note    Counts made by a running handler at the same time may be lost.
+ *
+ * @retval  None.
+ */
+void service_clear_stats(const service_t *svc)
+{
+	int32_t lock;
+
+	if (!svc)
+		return;
+
+	lock = osKernelLock();
+	(void)memset(&((service_t *)svc)->stats, 0, sizeof(service_stats_t));
+	(void)osKernelRestoreLock(lock);
+}
+
+#if (CONFIG_SERVICE_STATS_HIST_NUM % 4)
+#error "CONFIG_SERVICE_STATS_HIST_NUM must be a multiple of 4."
+#endif
+
+/**
+ * @brief   Dump the statistics of all the probed services.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+void service_dump_stats(void)
+{
+	const service_t *start = module_service$$Base;
+	const service_t *end = module_service$$Limit;
+	const service_t *svc;
+	service_stats_t stats;
+	unsigned int i;
+
+	for (svc = start; svc < end; svc++) {
+		if (!svc->owner)
+			continue;
+
+		(void)service_get_stats(svc, &stats);
+
+		pr_info(
+			"Service <%s> handled %u, drop %u, high water %u, wait max %uus, run max %uus.",
+			svc->name,
+			stats.handled_num,
+			stats.drop_num,
+			stats.queue_high_water,
+			stats.wait_max_us,
+			stats.run_max_us);
+
+		/* Plain values only, the traces may be formatted later */
+		for (i = 0; i < CONFIG_SERVICE_STATS_HIST_NUM; i += 4)
+			pr_info("Service <%s> wait histogram %u: %u %u %u %u",
+				svc->name,
+				i,
+				stats.wait_hist[i],
+				stats.wait_hist[i + 1],
+				stats.wait_hist[i + 2],
+				stats.wait_hist[i + 3]);
+
+		for (i = 0; i < CONFIG_SERVICE_STATS_HIST_NUM; i += 4)
+			pr_info("Service <%s> run histogram %u: %u %u %u %u",
+				svc->name,
+				i,
+				stats.run_hist[i],
+				stats.run_hist[i + 1],
+				stats.run_hist[i + 2],
+				stats.run_hist[i + 3]);
+	}
+}
+#endif
@@ -0,0 +1,520 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "cmsis_os2.h"
+#include "object.h"
+#include "err.h"
+#include "log.h"
+#include "message.h"
+#include "service.h"
+#include "service_transport.h"
+#include "service_bridge.h"
+#include "drv_uart.h"
+#include "drv_crc.h"
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE) \
+	&& defined(CONFIG_SERVICE_BRIDGE_ENABLE)
+
+/**
+ * @brief	Service bridge structure definitions.
+ *
+ * @note	The mutex serializes the sequence numbers and the frames
+ *		written to the port, the CRC unit is taken with the lock of its
+ *		driver. frame is only used by the receive thread, index is the
+ *		number of bytes of it already received.
+ */
+typedef struct {
+	const object *		obj;
+	const object *		port;
+	const object *		crc;
+	osMutexId_t		mutex_id;
+	osThreadId_t		thread_id;
+	unsigned char		seq;
+	unsigned int		tx_num;
+	unsigned int		rx_num;
+	unsigned int		error_num;
+	service_bridge_frame_t	frame;
+	unsigned int		index;
+} service_bridge_t;
+
+static service_bridge_t service_bridge;
+
+static const osMutexAttr_t service_bridge_mutex_attr = {
+	.name		= CONFIG_SERVICE_BRIDGE_MUTEX_NAME,
+	.attr_bits	= osMutexPrioInherit,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+};
+
+/* Matches crc32_words() of tools/service_bridge/service_bridge.py */
+static const crc_config_t service_bridge_crc_config = {
+	.initial_value	= CRC_CONFIG_INITIAL_VALUE_DEFAULT,
+	.polynomial	= CRC_CONFIG_POLYNOMIAL_DEFAULT,
+	.configs	= CRC_CONFIG_POLYNOMIAL_LENGTH_32B |
+			  CRC_CONFIG_INPUT_32B,
+};
+
+static const osThreadAttr_t service_bridge_thread_attr = {
+	.name		= CONFIG_SERVICE_BRIDGE_THREAD_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_SERVICE_BRIDGE_STACK_SIZE,
+	.priority	= CONFIG_SERVICE_BRIDGE_PRIORITY,
+};
+
+/**
+ * @brief	Fill the fields of a frame carrying a message.
+ *
+ * @param	frame Pointer to the frame to fill.
+ * @param	dst_hash Name hash of the destination service of the host.
+ * @param	src_hash Name hash of the source service, 0 for none.
+ * @param	type Message type.
+ * @param	message Message structure to send.
+ *
+ * @retval	None.
+ */
+static void service_bridge_fill(service_bridge_frame_t *	frame,
+				unsigned int			dst_hash,
+				unsigned int			src_hash,
+				message_type_t			type,
+				const message_t *		message)
+{
+	frame->sync[0] = SERVICE_BRIDGE_SYNC_0;
+	frame->sync[1] = SERVICE_BRIDGE_SYNC_1;
+	frame->seq = 0;
+	frame->type = (unsigned char)type;
+	frame->dst_hash = dst_hash;
+	frame->src_hash = src_hash;
+	frame->id = message->id;
+	frame->param0 = message->param0;
+	frame->param1 = message->param1;
+	frame->crc = 0;
+}
+
+/**
+ * @brief	Compute the CRC of a frame.
+ *
+ * @param	bridge Pointer to the bridge.
+ * @param	frame Pointer to the frame.
+ * @param	crc Pointer to the CRC computed.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ *
+ * @note	The unit is shared with the other users of the driver, the
+ *		configuration of the bridge is installed under the lock of the
+ *		driver on each frame.
+ */
+static int service_bridge_crc(service_bridge_t *		bridge,
+			      const service_bridge_frame_t *	frame,
+			      unsigned int *			crc)
+{
+	int ret;
+
+	ret = crc_lock(bridge->crc, osWaitForever);
+	if (ret)
+		return ret;
+
+	ret = crc_configure(bridge->crc, &service_bridge_crc_config);
+	if (!ret)
+		ret = crc_calculate(bridge->crc,
+				    frame,
+				    SERVICE_BRIDGE_CRC_WORDS,
+				    crc);
+
+	(void)crc_unlock(bridge->crc);
+
+	return ret;
+}
+
+/**
+ * @brief	Number a frame and compute its CRC.
+ *
+ * @param	bridge Pointer to the bridge.
+ * @param	frame Pointer to the frame to seal.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ *
+ * @note	Called with the mutex of the bridge held.
+ */
+static int service_bridge_seal(service_bridge_t *	bridge,
+			       service_bridge_frame_t * frame)
+{
+	frame->seq = bridge->seq++;
+
+	return service_bridge_crc(bridge, frame, &frame->crc);
+}
+
+/**
+ * @brief	Build the frame of a message for the host.
+ *
+ * @param	frame Pointer to the frame to build.
+ * @param	dst_hash Name hash of the destination service of the host.
+ * @param	src_hash Name hash of the source service, 0 for none.
+ * @param	type Message type.
+ * @param	message Message structure to send.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int service_bridge_encode(service_bridge_frame_t *	frame,
+			  unsigned int			dst_hash,
+			  unsigned int			src_hash,
+			  message_type_t		type,
+			  const message_t *		message)
+{
+	service_bridge_t *bridge = &service_bridge;
+	int ret;
+
+	if (!frame || !message)
+		return -EINVAL;
+
+	if (!bridge->mutex_id)
+		return -ENODEV;
+
+	service_bridge_fill(frame, dst_hash, src_hash, type, message);
+
+	(void)osMutexAcquire(bridge->mutex_id, osWaitForever);
+	ret = service_bridge_seal(bridge, frame);
+	(void)osMutexRelease(bridge->mutex_id);
+
+	return ret;
+}
+
+/**
+ * @brief	Check the sync pattern and the CRC of a frame received.
+ *
+ * @param	bridge Pointer to the bridge.
+ * @param	frame Pointer to the frame received.
+ *
+ * @retval	Returns 0 on success, -EIO for a corrupt frame, other negative
+ *		error code otherwise.
+ */
+static int service_bridge_check(service_bridge_t *		bridge,
+				const service_bridge_frame_t *	frame)
+{
+	unsigned int crc;
+	int ret;
+
+	if (frame->sync[0] != SERVICE_BRIDGE_SYNC_0
+	    || frame->sync[1] != SERVICE_BRIDGE_SYNC_1)
+		return -EIO;
+
+	ret = service_bridge_crc(bridge, frame, &crc);
+	if (ret)
+		return ret;
+
+	if (crc != frame->crc)
+		return -EIO;
+
+	return 0;
+}
+
+/**
+ * @brief	Deliver the message of a frame checked, count the frame.
+ *
+ * @param	bridge Pointer to the bridge.
+ * @param	frame Pointer to the frame received.
+ * @param	ret Result of service_bridge_check() on the frame.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_bridge_deliver(service_bridge_t *		bridge,
+				  const service_bridge_frame_t *	frame,
+				  int				ret)
+{
+	message_t message;
+	int32_t lock;
+
+	if (!ret) {
+		message.id = frame->id;
+		message.param0 = frame->param0;
+		message.param1 = frame->param1;
+		message.ptr = NULL;
+
+		ret = service_transport_deliver(bridge->obj,
+						frame->dst_hash,
+						frame->src_hash,
+						(message_type_t)frame->type,
+						&message);
+	}
+
+	lock = osKernelLock();
+	if (ret)
+		bridge->error_num++;
+	else
+		bridge->rx_num++;
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Check a frame received from the host, deliver its message.
+ *
+ * @param	frame Pointer to the frame received.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int service_bridge_decode(const service_bridge_frame_t *frame)
+{
+	service_bridge_t *bridge = &service_bridge;
+
+	if (!frame)
+		return -EINVAL;
+
+	if (!bridge->mutex_id)
+		return -ENODEV;
+
+	return service_bridge_deliver(bridge,
+				      frame,
+				      service_bridge_check(bridge, frame));
+}
+
+/**
+ * @brief	Write the frame of a message to the port.
+ *
+ * @param	obj Pointer to the bridge object handle.
+ * @param	dst_hash Name hash of the destination service of the host.
+ * @param	src_hash Name hash of the source service, 0 for none.
+ * @param	type Message type.
+ * @param	message Message structure to send.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ *
+ * @note	A frame only partly written to a full port is dropped by the
+ *		host on its CRC.
+ */
+static int service_bridge_send(const object *		obj,
+			       unsigned int		dst_hash,
+			       unsigned int		src_hash,
+			       message_type_t		type,
+			       const message_t *	message)
+{
+	service_bridge_t *bridge = (service_bridge_t *)obj->object_data;
+	service_bridge_frame_t frame;
+	int ret;
+
+	service_bridge_fill(&frame, dst_hash, src_hash, type, message);
+
+	/* Keep the frames in sequence order on the port */
+	(void)osMutexAcquire(bridge->mutex_id, osWaitForever);
+
+	ret = service_bridge_seal(bridge, &frame);
+	if (!ret) {
+		ret = uart_write(bridge->port, &frame, sizeof(frame));
+		if (ret == sizeof(frame)) {
+			bridge->tx_num++;
+			ret = 0;
+		} else if (ret >= 0) {
+			ret = -EFULL;
+		}
+	}
+
+	(void)osMutexRelease(bridge->mutex_id);
+
+	return ret;
+}
+
+/**
+ * @brief	Restart the frame received at its next sync pattern.
+ *
+ * @param	bridge Pointer to the bridge.
+ *
+ * @retval	None.
+ *
+ * @note	Called on a corrupt frame, the first byte is dropped and the
+ *		others are scanned again, as the host does, so that a frame
+ *		starting inside the corrupt one is not lost with it.
+ */
+static void service_bridge_resync(service_bridge_t *bridge)
+{
+	unsigned char *frame = (unsigned char *)&bridge->frame;
+	unsigned int size = sizeof(service_bridge_frame_t);
+	unsigned int i;
+
+	for (i = 1; i < size; i++) {
+		if (frame[i] != SERVICE_BRIDGE_SYNC_0)
+			continue;
+
+		if (i + 1 == size || frame[i + 1] == SERVICE_BRIDGE_SYNC_1)
+			break;
+	}
+
+	bridge->index = size - i;
+	if (bridge->index)
+		(void)memmove(frame, frame + i, bridge->index);
+}
+
+/**
+ * @brief	Receive thread, reassembles the frames read from the port.
+ *
+ * @param	argument Pointer to the bridge.
+ *
+ * @retval	None.
+ *
+ * @note	The port has no receive notification, it is polled. The bytes
+ *		before a sync pattern are skipped, a frame failing its CRC is
+ *		scanned again from its second byte.
+ */
+static void service_bridge_thread(void *argument)
+{
+	service_bridge_t *bridge = (service_bridge_t *)argument;
+	unsigned char *frame = (unsigned char *)&bridge->frame;
+	unsigned char buff[sizeof(service_bridge_frame_t)];
+	int len;
+	int ret;
+	int i;
+
+	while (1) {
+		len = uart_read(bridge->port, buff, sizeof(buff));
+		if (len <= 0) {
+			osDelay(CONFIG_SERVICE_BRIDGE_POLL_MS *
+				osKernelGetTickFreq() / 1000);
+			continue;
+		}
+
+		for (i = 0; i < len; i++) {
+			if (bridge->index == 0
+			    && buff[i] != SERVICE_BRIDGE_SYNC_0)
+				continue;
+
+			if (bridge->index == 1
+			    && buff[i] != SERVICE_BRIDGE_SYNC_1) {
+				bridge->index =
+					buff[i] == SERVICE_BRIDGE_SYNC_0 ? 1 : 0;
+				continue;
+			}
+
+			frame[bridge->index++] = buff[i];
+			if (bridge->index < sizeof(service_bridge_frame_t))
+				continue;
+
+			bridge->index = 0;
+
+			ret = service_bridge_check(bridge, &bridge->frame);
+			(void)service_bridge_deliver(bridge,
+						     &bridge->frame,
+						     ret);
+			if (ret == -EIO)
+				service_bridge_resync(bridge);
+		}
+	}
+}
+
+/**
+ * @brief	Get the number of frames written to the port.
+ *
+ * @retval	Returns the number of frames.
+ */
+unsigned int service_bridge_get_tx_num(void)
+{
+	return service_bridge.tx_num;
+}
+
+/**
+ * @brief	Get the number of frames delivered to the local services.
+ *
+ * @retval	Returns the number of frames.
+ */
+unsigned int service_bridge_get_rx_num(void)
+{
+	return service_bridge.rx_num;
+}
+
+/**
+ * @brief	Get the number of frames received and refused.
+ *
+ * @retval	Returns the number of frames failing the CRC or the delivery.
+ */
+unsigned int service_bridge_get_error_num(void)
+{
+	return service_bridge.error_num;
+}
+
+static const service_transport_intf_t service_bridge_intf = {
+	.send = service_bridge_send,
+};
+
+/**
+ * @brief	Probe the bridge, bind its port and create the receive thread.
+ *
+ * @param	obj Pointer to the bridge object handle.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_bridge_probe(const object *obj)
+{
+	service_bridge_t *bridge = (service_bridge_t *)obj->object_data;
+
+	(void)memset(bridge, 0, sizeof(service_bridge_t));
+
+	bridge->obj = obj;
+
+	bridge->port = object_get_binding(CONFIG_SERVICE_BRIDGE_PORT_NAME);
+	if (!bridge->port) {
+		pr_error("Object <%s> binding port <%s> failed.",
+			 obj->name,
+			 CONFIG_SERVICE_BRIDGE_PORT_NAME);
+		return -ENODEV;
+	}
+
+	bridge->crc = object_get_binding(CONFIG_SERVICE_BRIDGE_CRC_NAME);
+	if (!bridge->crc) {
+		pr_error("Object <%s> binding crc <%s> failed.",
+			 obj->name,
+			 CONFIG_SERVICE_BRIDGE_CRC_NAME);
+		return -ENODEV;
+	}
+
+	bridge->mutex_id = osMutexNew(&service_bridge_mutex_attr);
+	if (!bridge->mutex_id) {
+		pr_error("Object <%s> create mutex failed.", obj->name);
+		return -ENOMEM;
+	}
+
+	bridge->thread_id = osThreadNew(service_bridge_thread,
+					bridge,
+					&service_bridge_thread_attr);
+	if (!bridge->thread_id) {
+		pr_error("Object <%s> create thread failed.", obj->name);
+		(void)osMutexDelete(bridge->mutex_id);
+		bridge->mutex_id = NULL;
+		return -ENOMEM;
+	}
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+module_service_manager(CONFIG_SERVICE_BRIDGE_NAME,
+		       CONFIG_SERVICE_BRIDGE_LABEL,
+		       service_bridge_probe,
+		       NULL,
+		       (void *)&service_bridge_intf,
+		       &service_bridge,
+		       NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_SERVICE_BRIDGE_NAME,
+		       CONFIG_SERVICE_BRIDGE_LABEL,
+		       CONFIG_SERVICE_BRIDGE_PORT_NAME,
+		       CONFIG_SERVICE_BRIDGE_CRC_NAME);
+
+#endif
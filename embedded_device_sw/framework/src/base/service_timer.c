@@ -0,0 +1,538 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "cmsis_os2.h"
+#include "cmsis_compiler.h"
+#include "object.h"
+#include "err.h"
+#include "log.h"
+#include "message.h"
+#include "service.h"
+#include "service_timer.h"
+
+#if defined(CONFIG_SERVICE_TIMER_ENABLE)
+
+/**
+ * @brief	Timer wheel geometry, 4 levels of 64 slots.
+ *
+ * Level n holds the timers expiring in [64^n, 64^(n+1)) ticks, the slots
+ * of a level are moved down one level when the lower levels wrap.
+ */
+#define SERVICE_TIMER_LEVEL_BITS	6
+#define SERVICE_TIMER_LEVEL_SIZE	(1 << SERVICE_TIMER_LEVEL_BITS)
+#define SERVICE_TIMER_LEVEL_MASK	(SERVICE_TIMER_LEVEL_SIZE - 1)
+#define SERVICE_TIMER_LEVEL_NUM		4
+
+/**
+ * @brief	Longest delta the wheel can hold, farther timers are parked in
+ *		the last slot reachable and placed again when it is cascaded.
+ */
+#define SERVICE_TIMER_MAX_DELTA \
+	((1u << (SERVICE_TIMER_LEVEL_BITS * SERVICE_TIMER_LEVEL_NUM)) - 1)
+
+#define SERVICE_TIMER_FLAG_WAKEUP	0x00000001u
+
+/**
+ * @brief	Timer wheel structure definitions.
+ *
+ * @note	now is the last tick processed by the timer thread, the
+ *		pending bitmaps have one bit for every non-empty slot.
+ */
+typedef struct {
+	osThreadId_t		thread_id;
+	uint32_t		now;
+	uint32_t		wakeup;
+	int			sleeping;
+	unsigned int		active_num;
+	volatile unsigned int	drop_num;
+	volatile unsigned int	retry_num;
+	uint32_t		pending[SERVICE_TIMER_LEVEL_NUM][2];
+	service_timer_t *	slot[SERVICE_TIMER_LEVEL_NUM]
+	[SERVICE_TIMER_LEVEL_SIZE];
+} service_timer_wheel_t;
+
+static service_timer_wheel_t service_timer_wheel;
+
+#if defined(CONFIG_SERVICE_STATIC_ENABLE)
+static StaticTask_t service_timer_thread_cb;
+static uint64_t service_timer_thread_stack[
+	(CONFIG_SERVICE_TIMER_STACK_SIZE + 7) / 8];
+#endif
+
+static const osThreadAttr_t service_timer_thread_attr = {
+	.name		= CONFIG_SERVICE_TIMER_THREAD_NAME,
+	.attr_bits	= osThreadDetached,
+#if defined(CONFIG_SERVICE_STATIC_ENABLE)
+	.cb_mem		= &service_timer_thread_cb,
+	.cb_size	= sizeof(StaticTask_t),
+	.stack_mem	= service_timer_thread_stack,
+	.stack_size	= sizeof(service_timer_thread_stack),
+#else
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_SERVICE_TIMER_STACK_SIZE,
+#endif
+	.priority	= CONFIG_SERVICE_TIMER_PRIORITY,
+};
+
+/**
+ * @brief	Link a timer into the slot matching its expiry.
+ *
+ * @param	wheel Pointer to the timer wheel.
+ * @param	timer Pointer to the timer.
+ *
+ * @retval	None.
+ *
+ * @note	Called with the kernel locked. A timer already due is put into
+ *		the slot of the tick being processed.
+ */
+static void service_timer_link(service_timer_wheel_t *	wheel,
+			       service_timer_t *	timer)
+{
+	int32_t delta = (int32_t)(timer->expiry - wheel->now);
+	uint32_t expiry = timer->expiry;
+	unsigned int level;
+	unsigned int slot;
+
+	if (delta <= 0) {
+		expiry = wheel->now;
+		level = 0;
+	} else {
+		if ((uint32_t)delta > SERVICE_TIMER_MAX_DELTA) {
+			expiry = wheel->now + SERVICE_TIMER_MAX_DELTA;
+			delta = SERVICE_TIMER_MAX_DELTA;
+		}
+
+		for (level = 0; level < SERVICE_TIMER_LEVEL_NUM - 1; level++)
+			if ((uint32_t)delta <
+			    (1u << (SERVICE_TIMER_LEVEL_BITS * (level + 1))))
+				break;
+	}
+
+	slot = (expiry >> (SERVICE_TIMER_LEVEL_BITS * level)) &
+	       SERVICE_TIMER_LEVEL_MASK;
+
+	timer->level = level;
+	timer->slot = slot;
+	timer->next = wheel->slot[level][slot];
+	if (timer->next)
+		timer->next->pprev = &timer->next;
+	timer->pprev = &wheel->slot[level][slot];
+	wheel->slot[level][slot] = timer;
+
+	wheel->pending[level][slot >> 5] |= 1u << (slot & 31);
+}
+
+/**
+ * @brief	Unlink a timer from its slot.
+ *
+ * @param	wheel Pointer to the timer wheel.
+ * @param	timer Pointer to the timer.
+ *
+ * @retval	None.
+ *
+ * @note	Called with the kernel locked.
+ */
+static void service_timer_unlink(service_timer_wheel_t *	wheel,
+				 service_timer_t *		timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next)
+		timer->next->pprev = timer->pprev;
+
+	if (!wheel->slot[timer->level][timer->slot])
+		wheel->pending[timer->level][timer->slot >> 5] &=
+			~(1u << (timer->slot & 31));
+
+	timer->next = NULL;
+	timer->pprev = NULL;
+}
+
+/**
+ * @brief	Move the timers of the current slot of a level down.
+ *
+ * @param	wheel Pointer to the timer wheel.
+ * @param	level The level to cascade.
+ *
+ * @retval	None.
+ *
+ * @note	Called with the kernel locked.
+ */
+static void service_timer_cascade(service_timer_wheel_t *	wheel,
+				  unsigned int			level)
+{
+	unsigned int slot = (wheel->now >> (SERVICE_TIMER_LEVEL_BITS * level)) &
+			    SERVICE_TIMER_LEVEL_MASK;
+	service_timer_t *timer;
+
+	while ((timer = wheel->slot[level][slot]) != NULL) {
+		service_timer_unlink(wheel, timer);
+		service_timer_link(wheel, timer);
+	}
+}
+
+/**
+ * @brief	Ticks from now to the next tick with work to do.
+ *
+ * @param	wheel Pointer to the timer wheel.
+ *
+ * @retval	Returns the number of ticks, at least 1.
+ *
+ * @note	Called with the kernel locked. Either a level 0 slot has
+ *		timers or level 1 wraps, whichever comes first.
+ */
+static uint32_t service_timer_next(service_timer_wheel_t *wheel)
+{
+	uint32_t wrap = SERVICE_TIMER_LEVEL_SIZE -
+			(wheel->now & SERVICE_TIMER_LEVEL_MASK);
+	uint32_t shift = (wheel->now + 1) & SERVICE_TIMER_LEVEL_MASK;
+	uint64_t pending;
+	uint32_t low;
+	uint32_t high;
+	uint32_t ticks;
+
+	pending = ((uint64_t)wheel->pending[0][1] << 32) |
+		  wheel->pending[0][0];
+	if (!pending)
+		return wrap;
+
+	if (shift)
+		pending = (pending >> shift) |
+			  (pending << (SERVICE_TIMER_LEVEL_SIZE - shift));
+
+	low = (uint32_t)pending;
+	high = (uint32_t)(pending >> 32);
+
+	if (low)
+		ticks = __CLZ(__RBIT(low)) + 1;
+	else
+		ticks = __CLZ(__RBIT(high)) + 33;
+
+	return ticks < wrap ? ticks : wrap;
+}
+
+/**
+ * @brief	Process one tick, send the expired timer messages.
+ *
+ * @param	wheel Pointer to the timer wheel.
+ * @param	lock Pointer to the kernel lock state, updated on relocking.
+ *
+ * @retval	None.
+ *
+ * @note	Called with the kernel locked, the lock is dropped around every
+ *		send so a full receiver queue never holds up the wheel. An
+ *		expiry refused by a full queue is linked again for the next
+ *		tick, unless the timer was started or stopped meanwhile.
+ */
+static void service_timer_tick(service_timer_wheel_t *wheel, int32_t *lock)
+{
+	service_send_attr_t attr;
+	const service_t *svc;
+	service_timer_t *timer;
+	message_t msg;
+	unsigned int slot;
+	uint32_t now;
+	uint8_t gen;
+	int level;
+	int full;
+	int ret;
+
+	now = ++wheel->now;
+
+	for (level = SERVICE_TIMER_LEVEL_NUM - 1; level > 0; level--)
+		if (!(wheel->now &
+		      ((1u << (SERVICE_TIMER_LEVEL_BITS * level)) - 1)))
+			service_timer_cascade(wheel, level);
+
+	(void)memset(&attr, 0, sizeof(attr));
+	attr.overflow = SERVICE_OVERFLOW_FAIL;
+
+	slot = wheel->now & SERVICE_TIMER_LEVEL_MASK;
+
+	/* A start on an idle wheel moves now, the slot is not due then */
+	while (wheel->now == now && (timer = wheel->slot[0][slot]) != NULL) {
+		service_timer_unlink(wheel, timer);
+		timer->active = 0;
+		wheel->active_num--;
+
+		svc = timer->svc;
+		msg = timer->msg;
+		gen = timer->gen;
+
+		(void)osKernelRestoreLock(*lock);
+
+		ret = service_send_evt_attr(svc, &msg, &attr);
+		full = ret == -EPIPE || ret == -EFULL;
+		if (ret && !full) {
+			wheel->drop_num++;
+			pr_warning("Service <%s> timer event 0x%x dropped, ret %d.",
+				   service_get_name(svc),
+				   msg.id,
+				   ret);
+		}
+
+		*lock = osKernelLock();
+
+		/* The queue is full, try again on the next tick */
+		if (full && timer->gen == gen && !timer->active) {
+			timer->expiry = wheel->now + 1;
+			timer->active = 1;
+			service_timer_link(wheel, timer);
+			wheel->active_num++;
+			wheel->retry_num++;
+		}
+	}
+}
+
+/**
+ * @brief	Timer thread, advances the wheel with the kernel tick.
+ *
+ * @param	argument Pointer to the timer wheel.
+ *
+ * @retval	None.
+ */
+static void service_timer_thread(void *argument)
+{
+	service_timer_wheel_t *wheel = (service_timer_wheel_t *)argument;
+	uint32_t timeout;
+	int32_t delay;
+	int32_t lock;
+
+	while (1) {
+		lock = osKernelLock();
+
+		/* The wheel may have been moved forward by a start meanwhile */
+		while ((int32_t)(osKernelGetTickCount() - wheel->now) > 0)
+			service_timer_tick(wheel, &lock);
+
+		if (wheel->active_num) {
+			wheel->wakeup = wheel->now + service_timer_next(wheel);
+			delay = (int32_t)(wheel->wakeup - osKernelGetTickCount());
+			timeout = delay > 0 ? (uint32_t)delay : 0;
+		} else {
+			timeout = osWaitForever;
+		}
+
+		wheel->sleeping = timeout != 0;
+
+		(void)osKernelRestoreLock(lock);
+
+		if (timeout)
+			(void)osThreadFlagsWait(SERVICE_TIMER_FLAG_WAKEUP,
+						osFlagsWaitAny,
+						timeout);
+	}
+}
+
+/**
+ * @brief	Start a timer, the message is sent to the service on expiry.
+ *
+ * @param	timer Pointer to the timer, restarted if it is active.
+ * @param	svc Pointer to the destination service.
+ * @param	ms The timeout in milliseconds.
+ * @param	msg Pointer to the message, copied into the timer.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int service_timer_start(service_timer_t *	timer,
+			const service_t *	svc,
+			unsigned int		ms,
+			const message_t *	msg)
+{
+	service_timer_wheel_t *wheel = &service_timer_wheel;
+	uint64_t ticks;
+	int wakeup = 0;
+	int32_t lock;
+
+	if (!timer)
+		return -EINVAL;
+
+	if (!svc)
+		return -EINVAL;
+
+	if (!msg)
+		return -EINVAL;
+
+	ticks = ((uint64_t)ms * osKernelGetTickFreq() + 999) / 1000;
+	if (!ticks)
+		ticks = 1;
+
+	if (ticks > INT32_MAX)
+		return -EINVAL;
+
+	if (!wheel->thread_id)
+		return -ENODEV;
+
+	lock = osKernelLock();
+
+	if (timer->active) {
+		service_timer_unlink(wheel, timer);
+		wheel->active_num--;
+	}
+
+	/* Nothing to catch up with, skip the ticks gone by while idle */
+	if (!wheel->active_num)
+		wheel->now = osKernelGetTickCount();
+
+	timer->svc = svc;
+	timer->msg = *msg;
+	timer->expiry = osKernelGetTickCount() + (uint32_t)ticks;
+	timer->active = 1;
+	timer->gen++;
+
+	service_timer_link(wheel, timer);
+	wheel->active_num++;
+
+	if (wheel->sleeping &&
+	    (wheel->active_num == 1 ||
+	     (int32_t)(timer->expiry - wheel->wakeup) < 0)) {
+		wheel->sleeping = 0;
+		wakeup = 1;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	if (wakeup)
+		(void)osThreadFlagsSet(wheel->thread_id,
+				       SERVICE_TIMER_FLAG_WAKEUP);
+
+	return 0;
+}
+
+/**
+ * @brief	Stop a timer.
+ *
+ * @param	timer Pointer to the timer.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ *
+ * @note	A message already sent on expiry stays in the queue of the
+ *		service, the handler has to tell stale expiries apart.
+ */
+int service_timer_stop(service_timer_t *timer)
+{
+	service_timer_wheel_t *wheel = &service_timer_wheel;
+	int32_t lock;
+	int ret = 0;
+
+	if (!timer)
+		return -EINVAL;
+
+	lock = osKernelLock();
+
+	/* Also cancels the retry of an expiry being sent */
+	timer->gen++;
+
+	if (timer->active) {
+		service_timer_unlink(wheel, timer);
+		timer->active = 0;
+		wheel->active_num--;
+	} else {
+		ret = -EPERM;
+	}
+
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Check whether a timer is running.
+ *
+ * @param	timer Pointer to the timer.
+ *
+ * @retval	Returns 1 if the timer is active, 0 otherwise.
+ */
+int service_timer_is_active(const service_timer_t *timer)
+{
+	return timer ? timer->active : 0;
+}
+
+/**
+ * @brief	Get the number of running timers.
+ *
+ * @retval	Returns the number of running timers.
+ */
+unsigned int service_timer_get_active_num(void)
+{
+	return service_timer_wheel.active_num;
+}
+
+/**
+ * @brief	Get the number of expiries the destination service refused.
+ *
+ * @retval	Returns the number of dropped expiries.
+ *
+ * @note	A full queue does not drop the expiry, see
+ *		service_timer_get_retry_num().
+ */
+unsigned int service_timer_get_drop_num(void)
+{
+	return service_timer_wheel.drop_num;
+}
+
+/**
+ * @brief	Get the number of expiries sent again as the queue was full.
+ *
+ * @retval	Returns the number of retries.
+ */
+unsigned int service_timer_get_retry_num(void)
+{
+	return service_timer_wheel.retry_num;
+}
+
+/**
+ * @brief	Probe the timer wheel, create the timer thread.
+ *
+ * @param	obj Pointer to the wheel object handle.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_timer_probe(const object *obj)
+{
+	service_timer_wheel_t *wheel =
+		(service_timer_wheel_t *)obj->object_data;
+
+	(void)memset(wheel, 0, sizeof(service_timer_wheel_t));
+
+	wheel->now = osKernelGetTickCount();
+
+	wheel->thread_id = osThreadNew(service_timer_thread,
+				       wheel,
+				       &service_timer_thread_attr);
+	if (!wheel->thread_id) {
+		pr_error("Object <%s> create thread failed.", obj->name);
+		return -ENOMEM;
+	}
+
+	pr_info("Object <%s> probe succeed.", obj->name);
+
+	return 0;
+}
+
+module_service_manager(CONFIG_SERVICE_TIMER_NAME,
+		       CONFIG_SERVICE_TIMER_LABEL,
+		       service_timer_probe,
+		       NULL,
+		       NULL,
+		       &service_timer_wheel,
+		       NULL);
+
+#endif
@@ -0,0 +1,362 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "cmsis_os2.h"
+#include "object.h"
+#include "err.h"
+#include "log.h"
+#include "message.h"
+#include "service.h"
+#include "service_transport.h"
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE)
+
+static int service_init_remote(const object *			obj,
+			       const service_config_t *	config);
+static int service_deinit_remote(const object *obj);
+static int service_send_message_remote(const object *			obj,
+				       const service_message_t *	service_message,
+				       service_overflow_t		overflow);
+
+const service_intf_t service_intf_remote = {
+	.init		= service_init_remote,
+	.deinit		= service_deinit_remote,
+	.send_message	= service_send_message_remote,
+	.handle_message = NULL,
+	.handle_messages = NULL,
+};
+
+extern service_t module_service$$Base[];
+extern service_t module_service$$Limit[];
+
+/**
+ * @brief	Name hashes of the services, by index in the service section.
+ *
+ * @note	Filled on first use, the services never change after the link.
+ */
+typedef struct {
+	unsigned int	hash[CONFIG_SERVICE_MAX_NUM];
+	unsigned int	num;
+	int		initialized;
+} service_transport_hash_table_t;
+
+static service_transport_hash_table_t service_transport_hash_table;
+
+/**
+ * @brief	Fill the name hashes of the services.
+ *
+ * @param	None.
+ *
+ * @retval	None.
+ */
+static void service_transport_hash_init(void)
+{
+	service_transport_hash_table_t *table = &service_transport_hash_table;
+	unsigned int num = module_service$$Limit - module_service$$Base;
+	unsigned int i;
+	int32_t lock;
+
+	if (num > CONFIG_SERVICE_MAX_NUM)
+		num = CONFIG_SERVICE_MAX_NUM;
+
+	lock = osKernelLock();
+
+	if (!table->initialized) {
+		for (i = 0; i < num; i++)
+			table->hash[i] =
+				object_hash_name(module_service$$Base[i].name);
+
+		table->num = num;
+		table->initialized = 1;
+	}
+
+	(void)osKernelRestoreLock(lock);
+}
+
+/**
+ * @brief	Get the name hash of a service.
+ *
+ * @param	svc Pointer to the service handle, may be NULL.
+ *
+ * @retval	Returns the name hash, 0 for NULL.
+ */
+static unsigned int service_transport_hash(const service_t *svc)
+{
+	service_transport_hash_table_t *table = &service_transport_hash_table;
+	unsigned int index;
+
+	if (!svc)
+		return 0;
+
+	if (!table->initialized)
+		service_transport_hash_init();
+
+	index = svc - module_service$$Base;
+	if (index >= table->num)
+		return object_hash_name(svc->name);
+
+	return table->hash[index];
+}
+
+/**
+ * @brief	Check whether the service is a proxy of a peer service.
+ *
+ * @param	svc Pointer to the service handle.
+ *
+ * @retval	Returns 1 if the service is remote, 0 otherwise.
+ */
+int service_is_remote(const service_t *svc)
+{
+	return svc->owner && svc->owner->object_intf == &service_intf_remote;
+}
+
+/**
+ * @brief	Bind the proxy to its transport.
+ *
+ * @param	obj Pointer to the service object handle.
+ * @param	config Pointer to the configuration space, unused.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_init_remote(const object *			obj,
+			       const service_config_t *	config)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_remote_t *remote = (service_remote_t *)svc->priv;
+
+	(void)config;
+
+	remote->transport = object_get_binding(remote->transport_name);
+	if (!remote->transport) {
+		pr_error("Service <%s> binding transport <%s> failed.",
+			 svc->name,
+			 remote->transport_name);
+		return -ENODEV;
+	}
+
+	remote->remote_hash = object_hash_name(remote->remote_name);
+
+	pr_info("Service <%s> is a proxy of <%s> on transport <%s>.",
+		svc->name,
+		remote->remote_name,
+		remote->transport_name);
+
+	return 0;
+}
+
+/**
+ * @brief	Unbind the proxy from its transport.
+ *
+ * @param	obj Pointer to the service object handle.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_deinit_remote(const object *obj)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_remote_t *remote = (service_remote_t *)svc->priv;
+
+	remote->transport = NULL;
+
+	return 0;
+}
+
+/**
+ * @brief	Pass a message to the peer service through the transport.
+ *
+ * @param	obj Pointer to the service object handle.
+ * @param	service_message Service message to send.
+ * @param	overflow What to do if the transport is full, unused.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+static int service_send_message_remote(const object *			obj,
+				       const service_message_t *	service_message,
+				       service_overflow_t		overflow)
+{
+	service_t *svc = (service_t *)obj->object_data;
+	service_remote_t *remote = (service_remote_t *)svc->priv;
+	int32_t lock;
+	int ret;
+
+	(void)overflow;
+
+	if (!remote->transport)
+		return -ENODEV;
+
+	/* Neither the call slot nor the payload can cross the transport */
+	if (service_message->call || service_message->msg.ptr)
+		return -ENOSUPPORT;
+
+	ret = service_transport_send(remote->transport,
+				     remote->remote_hash,
+				     service_transport_hash(service_message->src),
+				     service_message->type,
+				     &service_message->msg);
+
+	lock = osKernelLock();
+	if (ret)
+		remote->drop_num++;
+	else
+		remote->send_num++;
+	(void)osKernelRestoreLock(lock);
+
+	return ret;
+}
+
+/**
+ * @brief	Search a local service by its name hash.
+ *
+ * @param	hash Name hash of the service.
+ *
+ * @retval	Service handle, or NULL if none is found.
+ */
+static const service_t *service_transport_search_local(unsigned int hash)
+{
+	service_transport_hash_table_t *table = &service_transport_hash_table;
+	unsigned int i;
+
+	if (!table->initialized)
+		service_transport_hash_init();
+
+	for (i = 0; i < table->num; i++)
+		if (table->hash[i] == hash
+		    && !service_is_remote(&module_service$$Base[i]))
+			return &module_service$$Base[i];
+
+	return NULL;
+}
+
+/**
+ * @brief	Search the proxy of a peer service on the transport.
+ *
+ * @param	transport Pointer to the transport object handle.
+ * @param	hash Name hash of the peer service.
+ *
+ * @retval	Service handle, or NULL if none is found.
+ */
+static const service_t *service_transport_search_remote(
+	const object *	transport,
+	unsigned int	hash)
+{
+	const service_t *start = module_service$$Base;
+	const service_t *end = module_service$$Limit;
+	const service_remote_t *remote;
+	const service_t *svc;
+
+	for (svc = start; svc < end; svc++) {
+		if (!service_is_remote(svc))
+			continue;
+
+		remote = (const service_remote_t *)svc->priv;
+		if (remote->transport == transport
+		    && remote->remote_hash == hash)
+			return svc;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief	Deliver a message from the peer to a local service.
+ *
+ * @param	transport Pointer to the transport object handle.
+ * @param	dst_hash Name hash of the local destination service.
+ * @param	src_hash Name hash of the peer source service, 0 for none.
+ * @param	type Message type.
+ * @param	message Message structure received.
+ *
+ * @note	Called by the transport from thread context. The message is
+ *		sent as if it came from a local service, the source of a
+ *		request or a respond is the proxy of the peer service.
+ *
+ * @retval	Returns 0 on success, negative error code otherwise.
+ */
+int service_transport_deliver(const object *	transport,
+			      unsigned int	dst_hash,
+			      unsigned int	src_hash,
+			      message_type_t	type,
+			      const message_t * message)
+{
+	const service_t *dst;
+	const service_t *src = NULL;
+	message_t local_message;
+
+	if (!transport || !message)
+		return -EINVAL;
+
+	dst = service_transport_search_local(dst_hash);
+	if (!dst)
+		return -ENOENT;
+
+	if (type == MSG_TYPE_REQ || type == MSG_TYPE_RSP) {
+		src = service_transport_search_remote(transport, src_hash);
+		if (!src)
+			return -ENOENT;
+	}
+
+	local_message = *message;
+	local_message.ptr = NULL;
+
+	switch (type) {
+	case MSG_TYPE_EVT:
+		return service_send_evt(dst, &local_message);
+
+	case MSG_TYPE_REQ:
+		return service_send_req(dst, src, &local_message);
+
+	case MSG_TYPE_RSP:
+		return service_send_rsp(dst, src, &local_message);
+
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * @brief	Get the number of messages passed to the transport.
+ *
+ * @param	svc Pointer to the service handle.
+ *
+ * @retval	Returns the number of messages, 0 if the service is local.
+ */
+unsigned int service_remote_get_send_num(const service_t *svc)
+{
+	if (!service_is_remote(svc))
+		return 0;
+
+	return ((const service_remote_t *)svc->priv)->send_num;
+}
+
+/**
+ * @brief	Get the number of messages the transport failed to send.
+ *
+ * @param	svc Pointer to the service handle.
+ *
+ * @retval	Returns the number of messages, 0 if the service is local.
+ */
+unsigned int service_remote_get_drop_num(const service_t *svc)
+{
+	if (!service_is_remote(svc))
+		return 0;
+
+	return ((const service_remote_t *)svc->priv)->drop_num;
+}
+
+#endif
@@ -18,6 +18,7 @@
 
 #include <string.h>
 #include "service.h"
+#include "service_timer.h"
 #include "led_id.h"
 #include "led_hardware.h"
 #include "led_pattern.h"
@@ -26,6 +27,15 @@
 
 #if defined(CONFIG_LED_SERVICE_ENABLE)
 
+#if defined(CONFIG_LED_SERVICE_STATIC_ENABLE) \
+	&& !defined(CONFIG_SERVICE_STATIC_ENABLE)
+#error "CONFIG_LED_SERVICE_STATIC_ENABLE needs CONFIG_SERVICE_STATIC_ENABLE."
+#endif
+
+#if !defined(CONFIG_SERVICE_TIMER_ENABLE)
+#error "CONFIG_LED_SERVICE_ENABLE needs CONFIG_SERVICE_TIMER_ENABLE."
+#endif
+
 #define led_error   pr_error
 #define led_warning pr_warning
 #define led_info    pr_info
@@ -36,8 +46,9 @@
  */
 typedef struct {
 	const object *	gpio;
-	osTimerId_t	timer;
+	service_timer_t	timer;
 	unsigned int	cycle_idx;
+	unsigned int	generation;
 } led_service_runtime_t;
 
 /**
@@ -81,23 +92,42 @@ static led_service_instance_t *led_instance_search_by_led_id(
 }
 
 /**
- * @brief   Attributes structure for led service timer.
+ * @brief   Start the timer of the current cycle.
+ *
+ * @param   priv Pointer to the private structure.
+ * @param   instance Pointer to the instance.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
  */
-const osTimerAttr_t led_service_timer_attr = {
-	.name		= CONFIG_LED_TIMER_NAME,
-	.attr_bits	= 0,
-	.cb_mem		= NULL,
-	.cb_size	= 0,
-};
+static int led_service_start_timer(led_service_priv_t *		priv_data,
+				   led_service_instance_t *	instance)
+{
+	message_t message;
+
+	message.id = MSG_ID_LED_TIMER_EXPIRED;
+	message.param0 = instance->led_id->id;
+	message.param1 = instance->runtime.generation;
+	message.ptr = NULL;
+
+	return service_timer_start(&instance->runtime.timer,
+				   priv_data->owner_svc,
+				   instance->pattern->cycle[instance->runtime.
+							    cycle_idx].time_ms,
+				   &message);
+}
 
 /**
- * @brief   Timer callback function.
+ * @brief   Move the pattern to the next cycle when the timer expired.
+ *
+ * @param   priv Pointer to the private structure.
+ * @param   instance Pointer to the instance.
+ *
+ * @retval  None.
  */
-static void led_service_timer_callback(void *argument)
+static void led_service_timer_expired(led_service_priv_t *	priv_data,
+				      led_service_instance_t *	instance)
 {
-	led_service_instance_t *instance = (led_service_instance_t *)argument;
 	gpio_pin_level_t level;
-	osStatus_t stat;
 	int ret;
 
 	instance->runtime.cycle_idx++;
@@ -129,18 +159,14 @@ static void led_service_timer_callback(void *argument)
 			level,
 			ret);
 
-	stat =
-		osTimerStart(instance->runtime.timer,
-			     instance->pattern->cycle[instance->runtime.
-						      cycle_idx].time_ms * osKernelGetTickFreq() /
-			     1000);
-	if (stat != osOK)
+	ret = led_service_start_timer(priv_data, instance);
+	if (ret)
 		led_error(
-			"Start Timer period %d failed, led %d <%s>, stat %d.",
+			"Start Timer period %d failed, led %d <%s>, ret %d.",
 			instance->pattern->cycle[instance->runtime.cycle_idx].time_ms,
 			instance->led_id->id,
 			instance->led_id->name,
-			stat);
+			ret);
 }
 
 /**
@@ -167,28 +193,6 @@ static int led_service_init(const service_t *svc, void *priv)
 			led_hardware_search_by_index(i);
 		priv_data->instance[i].pattern = NULL;
 		priv_data->instance[i].runtime.cycle_idx = 0;
-		priv_data->instance[i].runtime.timer = osTimerNew(
-			led_service_timer_callback,
-			osTimerOnce,
-			&priv_data->instance[i],
-			&led_service_timer_attr);
-		if (!priv_data->instance[i].runtime.timer) {
-			led_error(
-				"Service <%s> create timer <%s> in instance %d failed.",
-				svc->name,
-				osTimerGetName(priv_data->instance[i].runtime.
-					       timer),
-				i);
-			return -EINVAL;
-		} else {
-			led_info(
-				"Service <%s> create timer <%s> in instance %d succeed.",
-				svc->name,
-				osTimerGetName(priv_data->instance[i].runtime.
-					       timer),
-				i);
-		}
-
 		priv_data->instance[i].runtime.gpio = object_get_binding(
 			priv_data->instance[i].hardware->port);
 		if (!priv_data->instance[i].runtime.gpio) {
@@ -237,36 +241,20 @@ static int led_service_deinit(const service_t *svc, void *priv)
 {
 	led_service_priv_t *priv_data = (led_service_priv_t *)priv;
 	unsigned int i;
-	osStatus_t stat;
 
 	for (i = 0; i < CONFIG_LED_INSTANCE_NUM; i++) {
+		(void)service_timer_stop(&priv_data->instance[i].runtime.timer);
+		priv_data->instance[i].runtime.generation++;
 		priv_data->instance[i].led_id = NULL;
 		priv_data->instance[i].hardware = NULL;
 		priv_data->instance[i].pattern = NULL;
-		stat = osTimerDelete(priv_data->instance[i].runtime.timer);
-		if (stat != osOK) {
-			led_error(
-				"Service <%s> delete timer <%s> in instance %d failed.",
-				svc->name,
-				osTimerGetName(priv_data->instance[i].runtime.
-					       timer),
-				i);
-			return -EINVAL;
-		} else {
-			led_info(
-				"Service <%s> delete timer <%s> in instance %d succeed.",
-				svc->name,
-				osTimerGetName(priv_data->instance[i].runtime.
-					       timer),
-				i);
-		}
 	}
 
 	return 0;
 }
 
 /**
- * @brief   Handle the LED service message.
+ * @brief   Handle the LED start event.
  *
  * @param   message Pointer to the received message.
  * @param 	rsp_message Pointer to the respond message.
@@ -274,122 +262,178 @@ static int led_service_deinit(const service_t *svc, void *priv)
  *
  * @retval  None.
  */
-static void led_service_handle_message(const message_t *message,
-				       message_t *	rsp_message,
-				       void *		priv)
+static void led_service_handle_start(const message_t *	message,
+				     message_t *	rsp_message,
+				     void *		priv)
 {
 	led_service_priv_t *priv_data = (led_service_priv_t *)priv;
 	led_service_instance_t *instance;
 	unsigned int id;
 	led_pattern_id_t pattern_id;
 	gpio_pin_level_t level;
-	osStatus_t stat;
 	int ret;
 
-	switch (message->id) {
-	case MSG_ID_LED_START:
+	id = message->param0;
+	pattern_id = (led_pattern_id_t)message->param1;
 
-		id = message->param0;
-		pattern_id = (led_pattern_id_t)message->param1;
+	led_info("Received event 0x%x [%d, %d].",
+		 MSG_ID_LED_START,
+		 id,
+		 pattern_id);
 
-		led_info("Received event 0x%x [%d, %d].",
-			 MSG_ID_LED_START,
-			 id,
-			 pattern_id);
+	instance = led_instance_search_by_led_id(priv_data, id);
+	if (!instance) {
+		led_error("Search led_id %d failed.", id);
+		return;
+	}
 
-		instance = led_instance_search_by_led_id(priv_data, id);
-		if (!instance) {
-			led_error("Search led_id %d failed.", id);
-			break;
-		}
+	instance->pattern = led_pattern_search_id(pattern_id);
+	if (!instance->pattern) {
+		led_error("Search pattern %d failed.", pattern_id);
+		return;
+	}
 
-		instance->pattern = led_pattern_search_id(pattern_id);
-		if (!instance->pattern) {
-			led_error("Search pattern %d failed.", pattern_id);
-			break;
-		}
+	if (!instance->hardware) {
+		led_error("Hardware is NULL.");
+		return;
+	}
 
-		if (!instance->hardware) {
-			led_error("Hardware is NULL.");
-			break;
-		}
+	(void)service_timer_stop(&instance->runtime.timer);
 
-		(void)osTimerStop(instance->runtime.timer);
+	instance->runtime.generation++;
+	instance->runtime.cycle_idx = 0;
 
-		instance->runtime.cycle_idx = 0;
+	if (instance->pattern->cycle[instance->runtime.cycle_idx].onoff)
+		level = instance->hardware->on;
+	else
+		level = instance->hardware->off;
 
-		if (instance->pattern->cycle[instance->runtime.cycle_idx].onoff)
-			level = instance->hardware->on;
-		else
-			level = instance->hardware->off;
+	ret = gpio_write(instance->runtime.gpio,
+			 instance->hardware->pin,
+			 level);
+	if (ret) {
+		led_error("Write gpio <%s> pin %d level %d failed, ret %d.",
+			  instance->runtime.gpio->name,
+			  instance->hardware->pin,
+			  level,
+			  ret);
+		return;
+	}
 
-		ret = gpio_write(instance->runtime.gpio,
-				 instance->hardware->pin,
-				 level);
-		if (ret) {
-			led_error(
-				"Write gpio <%s> pin %d level %d failed, ret %d.",
-				instance->runtime.gpio->name,
-				instance->hardware->pin,
-				level,
-				ret);
-			break;
-		}
+	ret = led_service_start_timer(priv_data, instance);
+	if (ret)
+		led_error("Start Timer period %d failed, led %d <%s>, ret %d.",
+			  instance->pattern->cycle[instance->runtime.
+						   cycle_idx].time_ms,
+			  instance->led_id->id,
+			  instance->led_id->name,
+			  ret);
+}
 
-		stat = osTimerStart(instance->runtime.timer,
-				    instance->pattern->cycle[instance->runtime.
-							     cycle_idx].time_ms * osKernelGetTickFreq() /
-				    1000);
-		if (stat != osOK) {
-			led_error(
-				"Start Timer period %d failed, led %d <%s>, stat %d.",
-				instance->pattern->cycle[instance->runtime.
-							 cycle_idx].time_ms,
-				instance->led_id->id,
-				instance->led_id->name,
-				stat);
-			break;
-		}
+/**
+ * @brief   Handle the LED stop event.
+ *
+ * @param   message Pointer to the received message.
+ * @param 	rsp_message Pointer to the respond message.
+ * @param   priv Pointer to the private structure.
+ *
+ * @retval  None.
+ */
+static void led_service_handle_stop(const message_t *	message,
+				    message_t *		rsp_message,
+				    void *		priv)
+{
+	led_service_priv_t *priv_data = (led_service_priv_t *)priv;
+	led_service_instance_t *instance;
+	unsigned int id;
+	int ret;
 
-		break;
+	id = message->param0;
 
-	case MSG_ID_LED_STOP:
+	led_info("Received event 0x%x [%d].",
+		 MSG_ID_LED_STOP,
+		 id);
 
-		id = message->param0;
+	instance = led_instance_search_by_led_id(priv_data, id);
+	if (!instance) {
+		led_error("Search led_id %d failed.", id);
+		return;
+	}
 
-		led_info("Received event 0x%x [%d].",
-			 MSG_ID_LED_STOP,
-			 id);
+	instance->runtime.generation++;
 
-		instance = led_instance_search_by_led_id(priv_data, id);
-		if (!instance) {
-			led_error("Search led_id %d failed.", id);
-			break;
-		}
+	ret = service_timer_stop(&instance->runtime.timer);
+	if (ret)
+		led_error("Stop Timer failed, led %d <%s>, ret %d.",
+			  instance->led_id->id,
+			  instance->led_id->name,
+			  ret);
+}
 
-		stat = osTimerStop(instance->runtime.timer);
-		if (stat != osOK) {
-			led_error("Stop Timer failed, led %d <%s>, stat %d.",
-				  instance->led_id->id,
-				  instance->led_id->name,
-				  stat);
-			break;
-		}
+/**
+ * @brief   Handle the LED cycle timer expiry.
+ *
+ * @param   message Pointer to the received message.
+ * @param 	rsp_message Pointer to the respond message.
+ * @param   priv Pointer to the private structure.
+ *
+ * @retval  None.
+ */
+static void led_service_handle_timer_expired(const message_t *	message,
+					     message_t *	rsp_message,
+					     void *		priv)
+{
+	led_service_priv_t *priv_data = (led_service_priv_t *)priv;
+	led_service_instance_t *instance;
+	unsigned int id;
 
-		break;
+	id = message->param0;
 
-	default:
-		break;
+	instance = led_instance_search_by_led_id(priv_data, id);
+	if (!instance) {
+		led_error("Search led_id %d failed.", id);
+		return;
 	}
+
+	/* Sent before the pattern was stopped or restarted */
+	if (message->param1 != instance->runtime.generation ||
+	    !instance->pattern)
+		return;
+
+	led_service_timer_expired(priv_data, instance);
 }
 
 static led_service_priv_t led_service_priv;
 
+#define LED_SERVICE_HANDLER_TABLE \
+	SERVICE_HANDLER_TABLE( \
+		SERVICE_HANDLER(MSG_ID_LED_START, led_service_handle_start), \
+		SERVICE_HANDLER(MSG_ID_LED_STOP, led_service_handle_stop), \
+		SERVICE_HANDLER(MSG_ID_LED_TIMER_EXPIRED, \
+				led_service_handle_timer_expired))
+
+#if defined(CONFIG_LED_SERVICE_STATIC_ENABLE)
+DECLARE_STATIC_SERVICE(CONFIG_LED_SERVICE_NAME,
+		       CONFIG_LED_SERVICE_LABEL,
+		       &led_service_priv,
+		       led_service_init,
+		       led_service_deinit,
+		       NULL,
+		       CONFIG_LED_SERVICE_STACK_SIZE,
+		       CONFIG_LED_SERVICE_QUEUE_LENGTH,
+		       SERVICE_SUBSCRIBE_NONE,
+		       SERVICE_COALESCE(MSG_ID_LED_START, MSG_ID_LED_STOP),
+		       SERVICE_DISPATCH(LED_SERVICE_HANDLER_TABLE));
+#else
 DECLARE_SERVICE(CONFIG_LED_SERVICE_NAME,
 		CONFIG_LED_SERVICE_LABEL,
 		&led_service_priv,
 		led_service_init,
 		led_service_deinit,
-		led_service_handle_message);
+		NULL,
+		SERVICE_SUBSCRIBE_NONE,
+		SERVICE_COALESCE(MSG_ID_LED_START, MSG_ID_LED_STOP),
+		SERVICE_DISPATCH(LED_SERVICE_HANDLER_TABLE));
+#endif
 
 #endif
@@ -19,6 +19,8 @@
 #ifndef __BSP_CONF_H__
 #define __BSP_CONF_H__
 
+#define CONFIG_CMSIS_DEVICE_HEADER "lm3s9b96_cmsis.h"
+
 #define CONFIG_CLOCK_ENABLE
 #if defined(CONFIG_CLOCK_ENABLE)
 #define CONFIG_CLOCK_NAME "lm3s9b96 clock driver"
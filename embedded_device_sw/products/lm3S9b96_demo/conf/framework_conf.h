@@ -21,16 +21,97 @@
 
 #define CONFIG_MSG_SEND_BLOCK_TIMEOUT_MS 20
 
+#define CONFIG_OBJECT_INDEX_MAX_NUM 64
+
+#define CONFIG_FLIGHT_RECORDER_ENABLE
+#if defined(CONFIG_FLIGHT_RECORDER_ENABLE)
+#define CONFIG_FLIGHT_RECORDER_NAME "flight recorder"
+#define CONFIG_FLIGHT_RECORDER_LABEL flight_recorder
+#define CONFIG_FLIGHT_RECORDER_RECORD_NUM 64
+#endif
+
+#define CONFIG_BOOT_PROFILE_ENABLE
+#if defined(CONFIG_BOOT_PROFILE_ENABLE)
+#define CONFIG_BOOT_PROFILE_RECORD_NUM 64
+#endif
+
+#define CONFIG_MSG_PAYLOAD_POOL_ENABLE
+#if defined(CONFIG_MSG_PAYLOAD_POOL_ENABLE)
+#define CONFIG_MSG_PAYLOAD_BLOCK_SIZE 256
+#define CONFIG_MSG_PAYLOAD_BLOCK_NUM 8
+#endif
+
 #define CONFIG_INIT_THREAD_NAME "init thread"
 #define CONFIG_INIT_THREAD_STACK_SIZE 2048
 #define CONFIG_INIT_THREAD_PRIORITY osPriorityRealtime
 
+#define CONFIG_OBJECT_INIT_WORKER_NAME "object init worker"
+#define CONFIG_OBJECT_INIT_WORKER_NUM 2
+#define CONFIG_OBJECT_INIT_WORKER_STACK_SIZE CONFIG_INIT_THREAD_STACK_SIZE
+#define CONFIG_OBJECT_INIT_WORKER_PRIORITY osPriorityRealtime
+
+#define CONFIG_OBJECT_LAZY_MUTEX_NAME "object lazy mutex"
+#define CONFIG_OBJECT_LAZY_TIMER_NAME "object lazy timer"
+#define CONFIG_OBJECT_LAZY_THREAD_NAME "object lazy thread"
+#define CONFIG_OBJECT_LAZY_THREAD_STACK_SIZE 1024
+#define CONFIG_OBJECT_LAZY_THREAD_PRIORITY osPriorityLow
+#define CONFIG_OBJECT_LAZY_IDLE_MS 10000
+
 #define CONFIG_SERVICE_DEFAULT_THREAD_NAME "default service thread"
 #define CONFIG_SERVICE_DEFAULT_THREAD_STACK_SIZE 2048
 #define CONFIG_SERVICE_DEFAULT_THREAD_PRIORITY osPriorityNormal
 
 #define CONFIG_SERVICE_DEFAULT_QUEUE_NAME "default service queue"
 #define CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH 10
+#define CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_NAME "default service urgent queue"
+#define CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_LENGTH 4
+
+#define CONFIG_SERVICE_MAX_NUM 32
+#define CONFIG_SERVICE_SUBSCRIPTION_MAX_NUM 32
+#define CONFIG_SERVICE_BATCH_MAX_NUM 8
+#define CONFIG_SERVICE_CALL_SLOT_NUM 4
+#define CONFIG_SERVICE_COALESCE_SLOT_NUM 4
+#define CONFIG_SERVICE_READY_TIMEOUT_MS 500
+
+#define CONFIG_SERVICE_STATIC_ENABLE
+#define CONFIG_SERVICE_EDF_ENABLE
+
+#define CONFIG_SERVICE_INLINE_ENABLE
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+#define CONFIG_SERVICE_INLINE_MAX_SIZE 64
+#endif
+
+#define CONFIG_SERVICE_STATS_ENABLE
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+#define CONFIG_SERVICE_STATS_NAME "service stats"
+#define CONFIG_SERVICE_STATS_LABEL service_stats
+#define CONFIG_SERVICE_STATS_THREAD_NAME "service stats thread"
+#define CONFIG_SERVICE_STATS_THREAD_STACK_SIZE 1024
+#define CONFIG_SERVICE_STATS_THREAD_PRIORITY osPriorityLow
+#define CONFIG_SERVICE_STATS_HIST_NUM 16
+#define CONFIG_SERVICE_STATS_DUMP_PERIOD_MS 60000
+#endif
+
+#define CONFIG_SERVICE_TIMER_ENABLE
+#if defined(CONFIG_SERVICE_TIMER_ENABLE)
+#define CONFIG_SERVICE_TIMER_NAME "service timer"
+#define CONFIG_SERVICE_TIMER_LABEL service_timer
+#define CONFIG_SERVICE_TIMER_THREAD_NAME "service timer thread"
+#define CONFIG_SERVICE_TIMER_STACK_SIZE 1024
+#define CONFIG_SERVICE_TIMER_PRIORITY osPriorityAboveNormal
+#endif
+
+#define CONFIG_SERVICE_ACTOR_ENABLE
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+#define CONFIG_SERVICE_ACTOR_NAME "service actor scheduler"
+#define CONFIG_SERVICE_ACTOR_LABEL service_actor_scheduler
+#define CONFIG_SERVICE_ACTOR_WORKER_NAME "service actor worker"
+#define CONFIG_SERVICE_ACTOR_WORKER_NUM 2
+#define CONFIG_SERVICE_ACTOR_WORKER_STACK_SIZE 2048
+#define CONFIG_SERVICE_ACTOR_WORKER_PRIORITY osPriorityNormal
+#define CONFIG_SERVICE_ACTOR_QUEUE_LENGTH 4
+#define CONFIG_SERVICE_ACTOR_BUDGET 8
+#endif
 
 #define CONFIG_UI_SERVICE_ENABLE
 #if defined(CONFIG_UI_SERVICE_ENABLE)
@@ -43,7 +124,11 @@
 #define CONFIG_LED_SERVICE_NAME "led service"
 #define CONFIG_LED_SERVICE_LABEL led_service
 
-#define CONFIG_LED_TIMER_NAME "default led timer"
+#define CONFIG_LED_SERVICE_STATIC_ENABLE
+#if defined(CONFIG_LED_SERVICE_STATIC_ENABLE)
+#define CONFIG_LED_SERVICE_STACK_SIZE 1024
+#define CONFIG_LED_SERVICE_QUEUE_LENGTH 4
+#endif
 #define CONFIG_LED_INSTANCE_NUM 2
 #define CONFIG_LED_ID_CONFIGS \
 	{ \
@@ -84,7 +84,7 @@ static int ui_service_deinit(const service_t *svc, void *priv)
 }
 
 /**
- * @brief   Handle the UI service message.
+ * @brief   Handle the system startup completed event.
  *
  * @param   message Pointer to the received message.
  * @param 	rsp_message Pointer to the respond message.
@@ -92,44 +92,35 @@ static int ui_service_deinit(const service_t *svc, void *priv)
  *
  * @retval  None.
  */
-static void ui_service_handle_message(const message_t * message,
-				      message_t *	rsp_message,
-				      void *		priv)
+static void ui_service_handle_startup_completed(const message_t *	message,
+						message_t *		rsp_message,
+						void *			priv)
 {
 	ui_service_priv_t *priv_data = (ui_service_priv_t *)priv;
 	message_t send_message;
 	int ret;
 
-	switch (message->id) {
-	case MSG_ID_SYS_STARTUP_COMPLETED:
-
-		send_message.id = MSG_ID_LED_START;
-		send_message.param0 = 0;
-		send_message.param1 = LED_PATTERN_QUICK_FLASH;
-		send_message.ptr = NULL;
-
-		ret = service_send_evt(priv_data->led_svc, &send_message);
-		if (ret)
-			ui_error("Send event 0x%x to <%s> failed.",
-				 send_message.id,
-				 priv_data->led_svc->name);
-
-		send_message.id = MSG_ID_LED_START;
-		send_message.param0 = 1;
-		send_message.param1 = LED_PATTERN_SLOW_FLASH;
-		send_message.ptr = NULL;
-
-		ret = service_send_evt(priv_data->led_svc, &send_message);
-		if (ret)
-			ui_error("Send event 0x%x to <%s> failed.",
-				 send_message.id,
-				 priv_data->led_svc->name);
-
-		break;
-
-	default:
-		break;
-	}
+	send_message.id = MSG_ID_LED_START;
+	send_message.param0 = 0;
+	send_message.param1 = LED_PATTERN_QUICK_FLASH;
+	send_message.ptr = NULL;
+
+	ret = service_send_evt(priv_data->led_svc, &send_message);
+	if (ret)
+		ui_error("Send event 0x%x to <%s> failed.",
+			 send_message.id,
+			 priv_data->led_svc->name);
+
+	send_message.id = MSG_ID_LED_START;
+	send_message.param0 = 1;
+	send_message.param1 = LED_PATTERN_SLOW_FLASH;
+	send_message.ptr = NULL;
+
+	ret = service_send_evt(priv_data->led_svc, &send_message);
+	if (ret)
+		ui_error("Send event 0x%x to <%s> failed.",
+			 send_message.id,
+			 priv_data->led_svc->name);
 }
 
 static ui_service_priv_t ui_service_priv;
@@ -139,6 +130,11 @@ DECLARE_SERVICE(CONFIG_UI_SERVICE_NAME,
 		&ui_service_priv,
 		ui_service_init,
 		ui_service_deinit,
-		ui_service_handle_message);
+		NULL,
+		SERVICE_SUBSCRIBE(MSG_ID_SYS_STARTUP_COMPLETED),
+		SERVICE_DISPATCH(
+			SERVICE_HANDLER_TABLE(
+				SERVICE_HANDLER(MSG_ID_SYS_STARTUP_COMPLETED,
+						ui_service_handle_startup_completed))));
 
 #endif
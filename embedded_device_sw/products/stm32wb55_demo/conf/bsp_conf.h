@@ -19,6 +19,8 @@
 #ifndef __BSP_CONF_H__
 #define __BSP_CONF_H__
 
+#define CONFIG_CMSIS_DEVICE_HEADER "stm32wb55xx.h"
+
 #define CONFIG_CLOCK_ENABLE
 #if defined(CONFIG_CLOCK_ENABLE)
 #define CONFIG_CLOCK_NAME "stm32wbxx clock driver"
@@ -47,6 +49,7 @@
 #if defined(CONFIG_UART1_ENABLE)
 #define CONFIG_UART1_NAME "stm32wbxx uart1 driver"
 #define CONFIG_UART1_LABEL stm32wbxx_uart1_driver
+#define CONFIG_UART1_MUTEX_NAME "stm32wbxx uart1 mutex"
 #define CONFIG_UART1_TX_RING_BUFF_SIZE (8 * 1024)
 #define CONFIG_UART1_RX_RING_BUFF_SIZE (2 * 1024)
 #define CONFIG_UART1_HW_BAUDRATE 115200
@@ -59,6 +62,7 @@
 #if defined(CONFIG_CRC_ENABLE)
 #define CONFIG_CRC_NAME "stm32wbxx crc driver"
 #define CONFIG_CRC_LABEL stm32wbxx_crc_driver
+#define CONFIG_CRC_MUTEX_NAME "stm32wbxx crc mutex"
 #define CONFIG_CRC_HW_INITIAL_VALUE CRC_CONFIG_INITIAL_VALUE_DEFAULT
 #define CONFIG_CRC_HW_POLYNOMIAL CRC_CONFIG_POLYNOMIAL_DEFAULT
 #define CONFIG_CRC_HW_CONFIGS CRC_CONFIG_POLYNOMIAL_LENGTH_32B | \
@@ -32,6 +32,8 @@
 #define CONFIG_TUNIT_TUNIT_SUIT_LABEL tunit_suite
 #define CONFIG_TUNIT_RING_BUFF_SUIT_NAME "ring buff test suite"
 #define CONFIG_TUNIT_RING_BUFF_SUIT_LABEL ring_buff_suite
+#define CONFIG_TUNIT_DBG_TRACE_SUIT_NAME "dbg trace test suite"
+#define CONFIG_TUNIT_DBG_TRACE_SUIT_LABEL dbg_trace_suite
 #define CONFIG_TUNIT_CRC_SUIT_NAME "crc test suite"
 #define CONFIG_TUNIT_CRC_SUIT_LABEL crc_suite
 #define CONFIG_TUNIT_SERVICE_SUIT_NAME "service test suite"
@@ -43,6 +45,38 @@
 #define CONFIG_TUNIT_SERVICE_BAR_LABEL bar_service
 #define CONFIG_TUNIT_SERVICE_BAZ_NAME "baz service"
 #define CONFIG_TUNIT_SERVICE_BAZ_LABEL baz_service
+#define CONFIG_TUNIT_SERVICE_QUX_NAME "qux service"
+#define CONFIG_TUNIT_SERVICE_QUX_LABEL qux_service
+#define CONFIG_TUNIT_SERVICE_EDF_NAME "edf service"
+#define CONFIG_TUNIT_SERVICE_EDF_LABEL edf_service
+#define CONFIG_TUNIT_SERVICE_PROXY_NAME "foo proxy"
+#define CONFIG_TUNIT_SERVICE_PROXY_LABEL foo_proxy
+#define CONFIG_TUNIT_TRANSPORT_NAME "loopback transport"
+#define CONFIG_TUNIT_TRANSPORT_LABEL loopback_transport
+#define CONFIG_TUNIT_LAZY_DEP_NAME "tcase lazy dependency"
+#define CONFIG_TUNIT_LAZY_DEP_LABEL tcase_lazy_dependency
+#define CONFIG_TUNIT_LAZY_USER_0_NAME "tcase lazy user 0"
+#define CONFIG_TUNIT_LAZY_USER_0_LABEL tcase_lazy_user_0
+#define CONFIG_TUNIT_LAZY_USER_1_NAME "tcase lazy user 1"
+#define CONFIG_TUNIT_LAZY_USER_1_LABEL tcase_lazy_user_1
+#define CONFIG_TUNIT_LAZY_USER_2_NAME "tcase lazy user 2"
+#define CONFIG_TUNIT_LAZY_USER_2_LABEL tcase_lazy_user_2
+#define CONFIG_TUNIT_PROBE_FAIL_NAME "tcase probe fail"
+#define CONFIG_TUNIT_PROBE_FAIL_LABEL tcase_probe_fail
+#define CONFIG_TUNIT_PROBE_CANCELED_NAME "tcase probe canceled"
+#define CONFIG_TUNIT_PROBE_CANCELED_LABEL tcase_probe_canceled
+#define CONFIG_TUNIT_PROBE_LOOP_0_NAME "tcase probe loop 0"
+#define CONFIG_TUNIT_PROBE_LOOP_0_LABEL tcase_probe_loop_0
+#define CONFIG_TUNIT_PROBE_LOOP_1_NAME "tcase probe loop 1"
+#define CONFIG_TUNIT_PROBE_LOOP_1_LABEL tcase_probe_loop_1
+#define CONFIG_TUNIT_PROBE_LATER_NAME "tcase probe later"
+#define CONFIG_TUNIT_PROBE_LATER_LABEL tcase_probe_later
+#define CONFIG_TUNIT_PROBE_WORKER_0_NAME "tcase probe worker 0"
+#define CONFIG_TUNIT_PROBE_WORKER_0_LABEL tcase_probe_worker_0
+#define CONFIG_TUNIT_PROBE_WORKER_1_NAME "tcase probe worker 1"
+#define CONFIG_TUNIT_PROBE_WORKER_1_LABEL tcase_probe_worker_1
+#define CONFIG_TUNIT_PROBE_WORKER_2_NAME "tcase probe worker 2"
+#define CONFIG_TUNIT_PROBE_WORKER_2_LABEL tcase_probe_worker_2
 #endif
 #endif
 
@@ -25,6 +25,17 @@
 #define CONFIG_DBG_TRACE_LABEL dbg_trace_module
 #define CONFIG_DBG_TRACE_PORT_NAME CONFIG_UART1_NAME
 #define CONFIG_DBG_TRACE_MAX_LEN 256
+
+#define CONFIG_DBG_TRACE_DEFERRED_ENABLE
+#if defined(CONFIG_DBG_TRACE_DEFERRED_ENABLE)
+#define CONFIG_DBG_TRACE_THREAD_NAME "dbg trace thread"
+#define CONFIG_DBG_TRACE_THREAD_STACK_SIZE 1024
+#define CONFIG_DBG_TRACE_THREAD_PRIORITY osPriorityLow
+#define CONFIG_DBG_TRACE_RING_LENGTH 64
+#define CONFIG_DBG_TRACE_ARG_NUM 8
+#define CONFIG_DBG_TRACE_STR_SIZE 48
+#define CONFIG_DBG_TRACE_FLUSH_MS 10
+#endif
 #endif
 
 #define CONFIG_TRACE_ENABLE
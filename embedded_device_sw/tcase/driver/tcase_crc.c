@@ -17,6 +17,7 @@
  */
 
 #include <string.h>
+#include "cmsis_os2.h"
 #include "drv_crc.h"
 #include "tunit.h"
 
@@ -91,6 +92,11 @@ static void tcace_crc_calculate(void)
 	config.polynomial = CRC_CONFIG_POLYNOMIAL_DEFAULT;
 	config.configs = CRC_CONFIG_POLYNOMIAL_LENGTH_32B |
 			 CRC_CONFIG_INPUT_32B;
+
+	/* The unit is shared with the service bridge */
+	ret = crc_lock(obj, osWaitForever);
+	TUNIT_TEST(ret == 0);
+
 	ret = crc_configure(obj, &config);
 	TUNIT_TEST(ret == 0);
 
@@ -100,7 +106,14 @@ static void tcace_crc_calculate(void)
 			      sizeof(raw_data_32B) / sizeof(raw_data_32B[0]),
 			      &crc);
 	TUNIT_TEST(ret == 0);
+
+	ret = crc_unlock(obj);
+	TUNIT_TEST(ret == 0);
+
 	TUNIT_TEST(crc == expected_crc_32B);
+
+	ret = object_put(obj);
+	TUNIT_TEST(ret == 0);
 }
 
 /**
@@ -126,6 +139,11 @@ static void tcace_crc_accumulate(void)
 	config.polynomial = CRC_CONFIG_POLYNOMIAL_DEFAULT;
 	config.configs = CRC_CONFIG_POLYNOMIAL_LENGTH_32B |
 			 CRC_CONFIG_INPUT_32B;
+
+	/* The unit is shared with the service bridge */
+	ret = crc_lock(obj, osWaitForever);
+	TUNIT_TEST(ret == 0);
+
 	ret = crc_configure(obj, &config);
 	TUNIT_TEST(ret == 0);
 
@@ -139,7 +157,13 @@ static void tcace_crc_accumulate(void)
 	ret = crc_accumulate(obj, pointer, len, &crc);
 	TUNIT_TEST(ret == 0);
 
+	ret = crc_unlock(obj);
+	TUNIT_TEST(ret == 0);
+
 	TUNIT_TEST(crc == expected_crc_32B);
+
+	ret = object_put(obj);
+	TUNIT_TEST(ret == 0);
 }
 
 define_tunit_suit(CONFIG_TUNIT_CRC_SUIT_NAME,
@@ -18,11 +18,25 @@
 
 #include <string.h>
 #include "service.h"
+#include "flight_recorder.h"
+#include "service_timer.h"
+#include "boot_profile.h"
+#include "service_transport.h"
+#include "service_bridge.h"
+#include "bsp_conf.h"
 #include "tunit.h"
 
 #ifdef CONFIG_TUNIT_SERVICE_SUIT_NAME
 
 #define DEF_MAX_MSG_BUFF_NUM 100
+#define DEF_ISR_RING_LENGTH 8
+
+/* The light test services run on the actor worker pool if it is enabled */
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+#define DECLARE_TCASE_LIGHT_SERVICE DECLARE_ACTOR_SERVICE
+#else
+#define DECLARE_TCASE_LIGHT_SERVICE DECLARE_SERVICE
+#endif
 
 #define DEF_MSG_SEND_PARAM_0 0xAA000000
 #define DEF_MSG_SEND_PARAM_1 0x55000000
@@ -47,10 +61,34 @@
 					 MSG_ID_TUNIT_SERVICE_BASE | 0x05)
 #define MSG_ID_SERVICE_DATA_BROADCAST   (MSG_TYPE_EVT_BASE | \
 					 MSG_ID_TUNIT_SERVICE_BASE | 0x06)
+#define MSG_ID_SERVICE_OTHER_BROADCAST  (MSG_TYPE_EVT_BASE | \
+					 MSG_ID_TUNIT_SERVICE_BASE | 0x07)
+#define MSG_ID_SERVICE_LATEST_EVT       (MSG_TYPE_EVT_BASE | \
+					 MSG_ID_TUNIT_SERVICE_BASE | 0x08)
+#define MSG_ID_SERVICE_INLINE_EVT       (MSG_TYPE_EVT_BASE | \
+					 MSG_ID_TUNIT_SERVICE_BASE | 0x09)
+#define MSG_ID_SERVICE_CALL_SELF_EVT    (MSG_TYPE_EVT_BASE | \
+					 MSG_ID_TUNIT_SERVICE_BASE | 0x0A)
+#define MSG_ID_SERVICE_SLEEP_EVT        (MSG_TYPE_EVT_BASE | \
+					 MSG_ID_TUNIT_SERVICE_BASE | 0x0B)
+
+#define DEF_COALESCE_KEY_NUM 2
+#define DEF_COALESCE_UPDATE_NUM 5
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+#define DEF_INLINE_QUEUE_SIZE 256
+#define DEF_FOO_INLINE_QUEUE SERVICE_INLINE_QUEUE(DEF_INLINE_QUEUE_SIZE)
+#else
+#define DEF_FOO_INLINE_QUEUE
+#endif
 
 typedef struct {
 	message_t	rcvd_message[DEF_MAX_MSG_BUFF_NUM];
 	int		rcvd_num;
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	unsigned char	inline_data[CONFIG_SERVICE_INLINE_MAX_SIZE];
+	unsigned int	inline_size;
+#endif
 } tcase_service_foo_priv_t;
 
 static int tcase_service_foo_init(const service_t *svc, void *priv)
@@ -81,6 +119,7 @@ static void tcase_service_foo_handle_message(const message_t *	message,
 
 		break;
 
+	case MSG_ID_SERVICE_LATEST_EVT:
 	case MSG_ID_SERVICE_DATA_EVT:
 
 		if (priv_data->rcvd_num < DEF_MAX_MSG_BUFF_NUM) {
@@ -137,6 +176,21 @@ static void tcase_service_foo_handle_message(const message_t *	message,
 
 		break;
 
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+	case MSG_ID_SERVICE_INLINE_EVT:
+
+		/* The payload is only valid in the handler */
+		priv_data->inline_size =
+			((const message_inline_t *)message->ptr)->size;
+		(void)memcpy(priv_data->inline_data,
+			     ((const message_inline_t *)message->ptr)->data,
+			     priv_data->inline_size);
+
+		priv_data->rcvd_num++;
+
+		break;
+#endif
+
 	default:
 		break;
 	}
@@ -149,7 +203,10 @@ DECLARE_SERVICE(CONFIG_TUNIT_SERVICE_FOO_NAME,
 		&service_foo_priv,
 		tcase_service_foo_init,
 		tcase_service_foo_deinit,
-		tcase_service_foo_handle_message);
+		tcase_service_foo_handle_message,
+		SERVICE_ISR_RING(DEF_ISR_RING_LENGTH),
+		SERVICE_COALESCE(MSG_ID_SERVICE_LATEST_EVT),
+		DEF_FOO_INLINE_QUEUE);
 
 typedef struct {
 	const service_t *	foo_svc;
@@ -302,6 +359,448 @@ DECLARE_SERVICE(CONFIG_TUNIT_SERVICE_BAR_NAME,
 		tcase_service_bar_deinit,
 		tcase_service_bar_handle_message);
 
+typedef struct {
+	message_t	rcvd_message[DEF_MAX_MSG_BUFF_NUM];
+	int		rcvd_num;
+	int		call_ret;
+} tcase_service_baz_priv_t;
+
+static int tcase_service_baz_init(const service_t *svc, void *priv)
+{
+	tcase_service_baz_priv_t *priv_data = (tcase_service_baz_priv_t *)priv;
+
+	(void)memset(priv_data, 0, sizeof(tcase_service_baz_priv_t));
+
+	return 0;
+}
+
+static int tcase_service_baz_deinit(const service_t *svc, void *priv)
+{
+	return 0;
+}
+
+static void tcase_service_baz_handle_message(const message_t *	message,
+					     message_t *	rsp_message,
+					     void *		priv)
+{
+	tcase_service_baz_priv_t *priv_data = (tcase_service_baz_priv_t *)priv;
+
+	/* Record everything, only the subscribed ID is expected */
+	if (priv_data->rcvd_num < DEF_MAX_MSG_BUFF_NUM) {
+		priv_data->rcvd_message[priv_data->rcvd_num].id =
+			message->id;
+		priv_data->rcvd_message[priv_data->rcvd_num].param0 =
+			message->param0;
+		priv_data->rcvd_message[priv_data->rcvd_num].param1 =
+			message->param1;
+		priv_data->rcvd_message[priv_data->rcvd_num].ptr =
+			message->ptr;
+	}
+
+	priv_data->rcvd_num++;
+
+	/* A call to itself can never be served */
+	if (message->id == MSG_ID_SERVICE_CALL_SELF_EVT) {
+		message_t req;
+		message_t rsp;
+
+		req.id = MSG_ID_SERVICE_DATA_REQ;
+		req.param0 = DEF_MSG_REQ_PARAM_0;
+		req.param1 = DEF_MSG_REQ_PARAM_1;
+		req.ptr = NULL;
+		priv_data->call_ret =
+			service_call(service_get_binding(
+					     CONFIG_TUNIT_SERVICE_BAZ_NAME),
+				     &req,
+				     &rsp,
+				     100 * osKernelGetTickFreq() / 1000);
+	}
+
+	if (message->id == MSG_ID_SERVICE_DATA_REQ) {
+		rsp_message->id = MSG_ID_SERVICE_DATA_RSP;
+		rsp_message->param0 = DEF_MSG_RSP_PARAM_0;
+		rsp_message->param1 = DEF_MSG_RSP_PARAM_1;
+		rsp_message->ptr = NULL;
+	}
+}
+
+static tcase_service_baz_priv_t service_baz_priv;
+
+DECLARE_TCASE_LIGHT_SERVICE(CONFIG_TUNIT_SERVICE_BAZ_NAME,
+			    CONFIG_TUNIT_SERVICE_BAZ_LABEL,
+			    &service_baz_priv,
+			    tcase_service_baz_init,
+			    tcase_service_baz_deinit,
+			    tcase_service_baz_handle_message,
+			    SERVICE_SUBSCRIBE(MSG_ID_SERVICE_DATA_BROADCAST));
+
+typedef struct {
+	message_t	rcvd_message[DEF_MAX_MSG_BUFF_NUM];
+	int		rcvd_num;
+	int		batch_num;
+	int		idle_num;
+} tcase_service_qux_priv_t;
+
+static int tcase_service_qux_init(const service_t *svc, void *priv)
+{
+	tcase_service_qux_priv_t *priv_data = (tcase_service_qux_priv_t *)priv;
+
+	(void)memset(priv_data, 0, sizeof(tcase_service_qux_priv_t));
+
+	return 0;
+}
+
+static int tcase_service_qux_deinit(const service_t *svc, void *priv)
+{
+	return 0;
+}
+
+static void tcase_service_qux_handle_messages(const message_t *	message,
+					      message_t *	rsp_message,
+					      unsigned int	num,
+					      void *		priv)
+{
+	tcase_service_qux_priv_t *priv_data = (tcase_service_qux_priv_t *)priv;
+	unsigned int i;
+
+	for (i = 0; i < num; i++) {
+		if (priv_data->rcvd_num < DEF_MAX_MSG_BUFF_NUM)
+			priv_data->rcvd_message[priv_data->rcvd_num] =
+				message[i];
+
+		priv_data->rcvd_num++;
+	}
+
+	priv_data->batch_num++;
+}
+
+static void tcase_service_qux_on_idle(void *priv)
+{
+	tcase_service_qux_priv_t *priv_data = (tcase_service_qux_priv_t *)priv;
+
+	priv_data->idle_num++;
+}
+
+static tcase_service_qux_priv_t service_qux_priv;
+
+DECLARE_TCASE_LIGHT_SERVICE(CONFIG_TUNIT_SERVICE_QUX_NAME,
+			    CONFIG_TUNIT_SERVICE_QUX_LABEL,
+			    &service_qux_priv,
+			    tcase_service_qux_init,
+			    tcase_service_qux_deinit,
+			    NULL,
+			    SERVICE_SUBSCRIBE_NONE,
+			    SERVICE_BATCH_HANDLER(tcase_service_qux_handle_messages),
+			    SERVICE_IDLE_HANDLER(tcase_service_qux_on_idle));
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+#define DEF_EDF_MSG_NUM 4
+
+typedef struct {
+	unsigned int	rcvd_param0[DEF_EDF_MSG_NUM];
+	int		rcvd_depth[DEF_EDF_MSG_NUM];
+	int		rcvd_num;
+} tcase_service_edf_priv_t;
+
+static int tcase_service_edf_init(const service_t *svc, void *priv)
+{
+	tcase_service_edf_priv_t *priv_data = (tcase_service_edf_priv_t *)priv;
+
+	(void)memset(priv_data, 0, sizeof(tcase_service_edf_priv_t));
+
+	return 0;
+}
+
+static int tcase_service_edf_deinit(const service_t *svc, void *priv)
+{
+	return 0;
+}
+
+static void tcase_service_edf_handle_message(const message_t *	message,
+					     message_t *	rsp_message,
+					     void *		priv)
+{
+	tcase_service_edf_priv_t *priv_data = (tcase_service_edf_priv_t *)priv;
+
+	switch (message->id) {
+	case MSG_ID_SERVICE_INIT_EVT:
+
+		(void)memset(priv_data, 0, sizeof(tcase_service_edf_priv_t));
+
+		break;
+
+	case MSG_ID_SERVICE_DATA_EVT:
+
+		if (priv_data->rcvd_num < DEF_EDF_MSG_NUM) {
+			priv_data->rcvd_param0[priv_data->rcvd_num] =
+				message->param0;
+			/* The messages left in the deadline heap */
+			priv_data->rcvd_depth[priv_data->rcvd_num] =
+				service_get_lane_depth(service_get_binding(
+					CONFIG_TUNIT_SERVICE_EDF_NAME),
+					SERVICE_LANE_NORMAL);
+		}
+
+		priv_data->rcvd_num++;
+
+		break;
+
+	case MSG_ID_SERVICE_SLEEP_EVT:
+
+		/* Hold the messages left in the deadline heap */
+		osDelay(message->param0 * osKernelGetTickFreq() / 1000);
+
+		break;
+
+	default:
+		break;
+	}
+}
+
+static tcase_service_edf_priv_t service_edf_priv;
+
+DECLARE_EDF_SERVICE(CONFIG_TUNIT_SERVICE_EDF_NAME,
+		    CONFIG_TUNIT_SERVICE_EDF_LABEL,
+		    &service_edf_priv,
+		    tcase_service_edf_init,
+		    tcase_service_edf_deinit,
+		    tcase_service_edf_handle_message,
+		    CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH,
+		    1,
+		    SERVICE_SUBSCRIBE_NONE);
+#endif
+
+/* More users than init workers, so some of them find every worker busy */
+static unsigned int tcase_lazy_dep_probe_num;
+
+static int tcase_lazy_dep_probe(const object *obj)
+{
+	tcase_lazy_dep_probe_num++;
+
+	return 0;
+}
+
+static int tcase_lazy_dep_shutdown(const object *obj)
+{
+	return 0;
+}
+
+static int tcase_lazy_user_probe(const object *obj)
+{
+	return 0;
+}
+
+/* Only the objects with an API can be bound by name */
+static const int tcase_lazy_intf;
+
+module_driver_lazy(CONFIG_TUNIT_LAZY_DEP_NAME,
+		   CONFIG_TUNIT_LAZY_DEP_LABEL,
+		   tcase_lazy_dep_probe,
+		   tcase_lazy_dep_shutdown,
+		   (void *)&tcase_lazy_intf,
+		   NULL,
+		   NULL);
+
+module_driver(CONFIG_TUNIT_LAZY_USER_0_NAME,
+	      CONFIG_TUNIT_LAZY_USER_0_LABEL,
+	      tcase_lazy_user_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_LAZY_USER_0_NAME,
+		       CONFIG_TUNIT_LAZY_USER_0_LABEL,
+		       CONFIG_TUNIT_LAZY_DEP_NAME);
+
+module_driver(CONFIG_TUNIT_LAZY_USER_1_NAME,
+	      CONFIG_TUNIT_LAZY_USER_1_LABEL,
+	      tcase_lazy_user_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_LAZY_USER_1_NAME,
+		       CONFIG_TUNIT_LAZY_USER_1_LABEL,
+		       CONFIG_TUNIT_LAZY_DEP_NAME);
+
+module_driver(CONFIG_TUNIT_LAZY_USER_2_NAME,
+	      CONFIG_TUNIT_LAZY_USER_2_LABEL,
+	      tcase_lazy_user_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_LAZY_USER_2_NAME,
+		       CONFIG_TUNIT_LAZY_USER_2_LABEL,
+		       CONFIG_TUNIT_LAZY_DEP_NAME);
+
+/* A failed probe, its dependent, a loop and a dependency on a later level */
+static int tcase_probe_fail_probe(const object *obj)
+{
+	return -EIO;
+}
+
+static int tcase_probe_ok_probe(const object *obj)
+{
+	return 0;
+}
+
+module_driver(CONFIG_TUNIT_PROBE_FAIL_NAME,
+	      CONFIG_TUNIT_PROBE_FAIL_LABEL,
+	      tcase_probe_fail_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+module_driver(CONFIG_TUNIT_PROBE_CANCELED_NAME,
+	      CONFIG_TUNIT_PROBE_CANCELED_LABEL,
+	      tcase_probe_ok_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_PROBE_CANCELED_NAME,
+		       CONFIG_TUNIT_PROBE_CANCELED_LABEL,
+		       CONFIG_TUNIT_PROBE_FAIL_NAME);
+
+module_driver(CONFIG_TUNIT_PROBE_LOOP_0_NAME,
+	      CONFIG_TUNIT_PROBE_LOOP_0_LABEL,
+	      tcase_probe_ok_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_PROBE_LOOP_0_NAME,
+		       CONFIG_TUNIT_PROBE_LOOP_0_LABEL,
+		       CONFIG_TUNIT_PROBE_LOOP_1_NAME);
+
+module_driver(CONFIG_TUNIT_PROBE_LOOP_1_NAME,
+	      CONFIG_TUNIT_PROBE_LOOP_1_LABEL,
+	      tcase_probe_ok_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_PROBE_LOOP_1_NAME,
+		       CONFIG_TUNIT_PROBE_LOOP_1_LABEL,
+		       CONFIG_TUNIT_PROBE_LOOP_0_NAME);
+
+module_driver(CONFIG_TUNIT_PROBE_LATER_NAME,
+	      CONFIG_TUNIT_PROBE_LATER_LABEL,
+	      tcase_probe_ok_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+DECLARE_OBJECT_DEPENDS(CONFIG_TUNIT_PROBE_LATER_NAME,
+		       CONFIG_TUNIT_PROBE_LATER_LABEL,
+		       CONFIG_TUNIT_SERVICE_FOO_NAME);
+
+/* Independent probes, slow enough to overlap on the init workers */
+typedef struct {
+	unsigned int	probe_num;
+	unsigned int	active_num;
+	unsigned int	active_max;
+} tcase_probe_worker_t;
+
+static tcase_probe_worker_t tcase_probe_worker;
+
+static int tcase_probe_worker_probe(const object *obj)
+{
+	tcase_probe_worker_t *worker = &tcase_probe_worker;
+	int32_t lock;
+
+	lock = osKernelLock();
+	worker->probe_num++;
+	if (++worker->active_num > worker->active_max)
+		worker->active_max = worker->active_num;
+	(void)osKernelRestoreLock(lock);
+
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	lock = osKernelLock();
+	worker->active_num--;
+	(void)osKernelRestoreLock(lock);
+
+	return 0;
+}
+
+module_driver(CONFIG_TUNIT_PROBE_WORKER_0_NAME,
+	      CONFIG_TUNIT_PROBE_WORKER_0_LABEL,
+	      tcase_probe_worker_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+module_driver(CONFIG_TUNIT_PROBE_WORKER_1_NAME,
+	      CONFIG_TUNIT_PROBE_WORKER_1_LABEL,
+	      tcase_probe_worker_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+module_driver(CONFIG_TUNIT_PROBE_WORKER_2_NAME,
+	      CONFIG_TUNIT_PROBE_WORKER_2_LABEL,
+	      tcase_probe_worker_probe,
+	      NULL,
+	      (void *)&tcase_lazy_intf,
+	      NULL,
+	      NULL);
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE)
+static int tcase_transport_loopback_probe(const object *obj)
+{
+	return 0;
+}
+
+static int tcase_transport_loopback_shutdown(const object *obj)
+{
+	return 0;
+}
+
+/* Delivers the messages back to the local services of the same name */
+static int tcase_transport_loopback_send(const object *		obj,
+					 unsigned int		dst_hash,
+					 unsigned int		src_hash,
+					 message_type_t		type,
+					 const message_t *	message)
+{
+	return service_transport_deliver(obj,
+					 dst_hash,
+					 src_hash,
+					 type,
+					 message);
+}
+
+static const service_transport_intf_t tcase_transport_loopback_intf = {
+	.send = tcase_transport_loopback_send,
+};
+
+module_service_manager(CONFIG_TUNIT_TRANSPORT_NAME,
+		       CONFIG_TUNIT_TRANSPORT_LABEL,
+		       tcase_transport_loopback_probe,
+		       tcase_transport_loopback_shutdown,
+		       (void *)&tcase_transport_loopback_intf,
+		       NULL,
+		       NULL);
+
+DECLARE_REMOTE_SERVICE(CONFIG_TUNIT_SERVICE_PROXY_NAME,
+		       CONFIG_TUNIT_SERVICE_PROXY_LABEL,
+		       CONFIG_TUNIT_SERVICE_FOO_NAME,
+		       CONFIG_TUNIT_TRANSPORT_NAME,
+		       SERVICE_SUBSCRIBE_NONE);
+#endif
+
 /**
  * @brief   Suite initialization function.
  *
@@ -389,6 +888,42 @@ static void tcace_service_check_structure(void)
 	TUNIT_ASSERT_PTR_EQUAL(obj->object_config, &service_config_default);
 }
 
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_binding_by_id(void)
+{
+	const service_t *svc;
+	const object *obj;
+	int id;
+
+	svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(svc);
+
+	id = object_get_id(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_FATAL(id >= 0);
+
+	obj = object_get_binding_by_id(id);
+	TUNIT_ASSERT_PTR_EQUAL(obj, service_get_owner(svc));
+	TUNIT_ASSERT_PTR_EQUAL(obj,
+			       object_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME));
+	TUNIT_ASSERT_PTR_EQUAL(service_get_binding_by_id(id), svc);
+
+	/* The bar service must get a different ID */
+	TUNIT_ASSERT_NOT_EQUAL(object_get_id(CONFIG_TUNIT_SERVICE_BAR_NAME), id);
+
+	/* Unknown names and IDs must be rejected */
+	TUNIT_ASSERT_EQUAL(object_get_id("unknown service"), -ENODEV);
+	TUNIT_ASSERT_PTR_NULL(object_get_binding("unknown service"));
+	TUNIT_ASSERT_PTR_NULL(service_get_binding("unknown service"));
+	TUNIT_ASSERT_PTR_NULL(object_get_binding_by_id(-1));
+	TUNIT_ASSERT_PTR_NULL(service_get_binding_by_id(-1));
+}
+
 /**
  * @brief   Testing function in a test case.
  *
@@ -685,6 +1220,8 @@ static void tcace_service_check_broadcast_evt(void)
 	tcase_service_foo_priv_t *foo_priv_data;
 	tcase_service_bar_priv_t *bar_priv_data;
 	message_t message;
+	unsigned int foo_drop_num;
+	unsigned int bar_drop_num;
 	int i;
 	int ret;
 
@@ -708,15 +1245,28 @@ static void tcace_service_check_broadcast_evt(void)
 	ret = service_send_evt(bar_svc, &message);
 	TUNIT_ASSERT_EQUAL(ret, 0);
 
+	foo_drop_num = service_get_broadcast_drop_num(foo_svc);
+	bar_drop_num = service_get_broadcast_drop_num(bar_svc);
+
 	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		/* Broadcast never blocks, let the receivers drain their queues */
+		while (!osMessageQueueGetSpace(foo_svc->queue_id)
+		       || !osMessageQueueGetSpace(bar_svc->queue_id))
+			osThreadYield();
+
 		message.id = MSG_ID_SERVICE_DATA_BROADCAST;
 		message.param0 = DEF_MSG_SEND_PARAM_0;
 		message.param1 = DEF_MSG_SEND_PARAM_1;
 		message.ptr = NULL;
-		ret = service_broadcast_evt(&message);
-		TUNIT_ASSERT_EQUAL(ret, 0);
+		(void)service_broadcast_evt(&message);
 	}
 
+	/* Other subscribers may drop, foo and bar always had room */
+	TUNIT_ASSERT_EQUAL(service_get_broadcast_drop_num(foo_svc),
+			   foo_drop_num);
+	TUNIT_ASSERT_EQUAL(service_get_broadcast_drop_num(bar_svc),
+			   bar_drop_num);
+
 	/* Waiting 10ms, for server async processing messages */
 	osDelay(10 * osKernelGetTickFreq() / 1000);
 
@@ -750,37 +1300,1963 @@ static void tcace_service_check_broadcast_evt(void)
 	}
 }
 
-define_tunit_suit(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  tcase_suit_initialize,
-		  tcase_suit_cleanup);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check structure test",
-		  tcace_service_check_structure);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check queue attr test",
-		  tcace_service_check_queue_attr);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check thread attr test",
-		  tcace_service_check_thread_attr);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check single queue evt",
-		  tcace_service_check_single_queue_evt);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check multi queue evt",
-		  tcace_service_check_multi_queue_evt);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check multi queue request",
-		  tcace_service_check_multi_queue_req);
-define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
-		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
-		  "Service check broadcast evt",
-		  tcace_service_check_broadcast_evt);
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_broadcast_subscribe(void)
+{
+	const service_t *baz_svc;
+	tcase_service_baz_priv_t *baz_priv_data;
+	message_t message;
+	unsigned int drop_num;
+	int ret;
+
+	baz_svc = service_get_binding(CONFIG_TUNIT_SERVICE_BAZ_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(baz_svc);
+
+	/* Waiting 10ms, for the queues to be drained */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	baz_priv_data = &service_baz_priv;
+	baz_priv_data->rcvd_num = 0;
+
+	drop_num = service_get_broadcast_drop_num(baz_svc);
+
+	message.id = MSG_ID_SERVICE_OTHER_BROADCAST;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	(void)service_broadcast_evt(&message);
+
+	message.id = MSG_ID_SERVICE_DATA_BROADCAST;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = NULL;
+	ret = service_broadcast_evt(&message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Only the subscribed message is delivered */
+	TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_message[0].id,
+			   MSG_ID_SERVICE_DATA_BROADCAST);
+	TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_message[0].param0,
+			   DEF_MSG_SEND_PARAM_0);
+	TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_message[0].param1,
+			   DEF_MSG_SEND_PARAM_1);
+	TUNIT_ASSERT_EQUAL(service_get_broadcast_drop_num(baz_svc), drop_num);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_batch_evt(void)
+{
+	const service_t *qux_svc;
+	tcase_service_qux_priv_t *qux_priv_data;
+	message_t message;
+	int i;
+	int ret;
+
+	qux_svc = service_get_binding(CONFIG_TUNIT_SERVICE_QUX_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(qux_svc);
+
+	qux_priv_data = &service_qux_priv;
+	(void)memset(qux_priv_data, 0, sizeof(tcase_service_qux_priv_t));
+
+	/* Queue a burst, it is drained in batches */
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt(qux_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Check the service test result */
+	TUNIT_ASSERT_EQUAL(qux_priv_data->rcvd_num,
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+	TUNIT_ASSERT(qux_priv_data->batch_num >= 1);
+	TUNIT_ASSERT(qux_priv_data->batch_num <=
+		     CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+	TUNIT_ASSERT(qux_priv_data->idle_num >= 1);
+
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++) {
+		TUNIT_ASSERT_EQUAL(qux_priv_data->rcvd_message[i].id,
+				   MSG_ID_SERVICE_DATA_EVT);
+		TUNIT_ASSERT_EQUAL(qux_priv_data->rcvd_message[i].param0, i);
+		TUNIT_ASSERT_EQUAL(qux_priv_data->rcvd_message[i].param1,
+				   DEF_MSG_SEND_PARAM_1);
+	}
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_urgent_lane(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	service_send_attr_t attr;
+	message_t message;
+	osPriority_t priority;
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Keep the receiver away until all the messages are queued */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt(foo_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	(void)memset(&attr, 0, sizeof(attr));
+	attr.lane = SERVICE_LANE_URGENT;
+
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = NULL;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_URGENT),
+			   1);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* The urgent message overtakes the backlog */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num,
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH + 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].param0,
+			   DEF_MSG_SEND_PARAM_0);
+
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++)
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i + 1].param0, i);
+
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_NORMAL),
+			   0);
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_URGENT),
+			   0);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_call(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	message_t rsp_message;
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* The caller is the test thread, it has no service queue */
+	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		message.id = MSG_ID_SERVICE_DATA_REQ;
+		message.param0 = DEF_MSG_REQ_PARAM_0;
+		message.param1 = DEF_MSG_REQ_PARAM_1;
+		message.ptr = NULL;
+		(void)memset(&rsp_message, 0, sizeof(rsp_message));
+		ret = service_call(foo_svc,
+				   &message,
+				   &rsp_message,
+				   100 * osKernelGetTickFreq() / 1000);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+
+		TUNIT_ASSERT_EQUAL(rsp_message.id, MSG_ID_SERVICE_DATA_RSP);
+		TUNIT_ASSERT_EQUAL(rsp_message.param0, DEF_MSG_RSP_PARAM_0);
+		TUNIT_ASSERT_EQUAL(rsp_message.param1, DEF_MSG_RSP_PARAM_1);
+		TUNIT_ASSERT_PTR_NULL(rsp_message.ptr);
+	}
+
+	/* Check the service test result */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, DEF_MAX_MSG_BUFF_NUM);
+
+	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].id,
+				   MSG_ID_SERVICE_DATA_REQ);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param0,
+				   DEF_MSG_REQ_PARAM_0);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param1,
+				   DEF_MSG_REQ_PARAM_1);
+	}
+
+	/* Invalid arguments */
+	ret = service_call(NULL, &message, &rsp_message, 0);
+	TUNIT_ASSERT_EQUAL(ret, -EINVAL);
+
+	ret = service_call(foo_svc, &message, NULL, 0);
+	TUNIT_ASSERT_EQUAL(ret, -EINVAL);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_isr_evt(void)
+{
+	const service_t *foo_svc;
+	const service_t *bar_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	osPriority_t priority;
+	unsigned int drop_num;
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	drop_num = service_get_isr_drop_num(foo_svc);
+
+	/* Keep the receiver away until the ring is full */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	for (i = 0; i < DEF_ISR_RING_LENGTH; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt_from_isr(foo_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	ret = service_send_evt_from_isr(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, -EFULL);
+	TUNIT_ASSERT_EQUAL(service_get_isr_drop_num(foo_svc), drop_num + 1);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Check the service test result */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, DEF_ISR_RING_LENGTH);
+
+	for (i = 0; i < DEF_ISR_RING_LENGTH; i++) {
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].id,
+				   MSG_ID_SERVICE_DATA_EVT);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param0, i);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param1,
+				   DEF_MSG_SEND_PARAM_1);
+	}
+
+	/* A service without ring can not be reached from interrupts */
+	bar_svc = service_get_binding(CONFIG_TUNIT_SERVICE_BAR_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(bar_svc);
+
+	ret = service_send_evt_from_isr(bar_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_overflow(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	service_send_attr_t attr;
+	message_t message;
+	osPriority_t priority;
+	unsigned int overflow_num[SERVICE_OVERFLOW_NUM];
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(service_queue_space(foo_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+
+	for (i = 0; i < SERVICE_OVERFLOW_NUM; i++)
+		overflow_num[i] = service_get_overflow_num(foo_svc,
+							   (service_overflow_t)i);
+
+	/* Keep the receiver away until all the messages are queued */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt(foo_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	TUNIT_ASSERT_EQUAL(service_queue_space(foo_svc, SERVICE_LANE_NORMAL),
+			   0);
+
+	(void)memset(&attr, 0, sizeof(attr));
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+
+	attr.overflow = SERVICE_OVERFLOW_FAIL;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, -EPIPE);
+
+	attr.overflow = SERVICE_OVERFLOW_DROP_NEWEST;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	attr.overflow = SERVICE_OVERFLOW_DROP_OLDEST;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	attr.overflow = SERVICE_OVERFLOW_NUM;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, -EINVAL);
+
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+
+	TUNIT_ASSERT_EQUAL(service_get_overflow_num(foo_svc,
+						    SERVICE_OVERFLOW_FAIL) -
+			   overflow_num[SERVICE_OVERFLOW_FAIL], 1);
+	TUNIT_ASSERT_EQUAL(service_get_overflow_num(foo_svc,
+						    SERVICE_OVERFLOW_DROP_NEWEST) -
+			   overflow_num[SERVICE_OVERFLOW_DROP_NEWEST], 1);
+	TUNIT_ASSERT_EQUAL(service_get_overflow_num(foo_svc,
+						    SERVICE_OVERFLOW_DROP_OLDEST) -
+			   overflow_num[SERVICE_OVERFLOW_DROP_OLDEST], 1);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* The oldest message made room for the last one */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num,
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+
+	for (i = 0; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH - 1; i++)
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param0, i + 1);
+
+	TUNIT_ASSERT_EQUAL(
+		foo_priv_data->rcvd_message[CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH - 1].param0,
+		DEF_MSG_SEND_PARAM_0);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_probe_status(void)
+{
+	const object *obj;
+
+#if defined(CONFIG_CLOCK_ENABLE)
+	/* Declared as a dependency of the drivers */
+	obj = object_get_binding(CONFIG_CLOCK_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), 0);
+#endif
+
+	obj = object_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), 0);
+
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(NULL), -EINVAL);
+
+	obj = object_get_binding(CONFIG_TUNIT_PROBE_FAIL_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), -EIO);
+
+	/* Its dependent is not probed */
+	obj = object_get_binding(CONFIG_TUNIT_PROBE_CANCELED_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), -ECANCELED);
+
+	obj = object_get_binding(CONFIG_TUNIT_PROBE_LOOP_0_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), -EDEADLK);
+
+	obj = object_get_binding(CONFIG_TUNIT_PROBE_LOOP_1_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), -EDEADLK);
+
+	/* foo is a service, probed after the drivers */
+	obj = object_get_binding(CONFIG_TUNIT_PROBE_LATER_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), -EDEADLK);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_probe_workers(void)
+{
+	const char *const names[] = {
+		CONFIG_TUNIT_PROBE_WORKER_0_NAME,
+		CONFIG_TUNIT_PROBE_WORKER_1_NAME,
+		CONFIG_TUNIT_PROBE_WORKER_2_NAME,
+	};
+	const object *obj;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+		obj = object_get_binding(names[i]);
+		TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+		TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), 0);
+	}
+
+	TUNIT_ASSERT_EQUAL(tcase_probe_worker.probe_num,
+			   sizeof(names) / sizeof(names[0]));
+	TUNIT_ASSERT_EQUAL(tcase_probe_worker.active_num, 0);
+
+	/* As many probes at once as workers, never more */
+#if (CONFIG_OBJECT_INIT_WORKER_NUM > 1)
+	TUNIT_ASSERT(tcase_probe_worker.active_max > 1);
+#endif
+	TUNIT_ASSERT(tcase_probe_worker.active_max <=
+		     (CONFIG_OBJECT_INIT_WORKER_NUM > 1 ?
+		      CONFIG_OBJECT_INIT_WORKER_NUM : 1));
+}
+
+#if defined(CONFIG_CRC_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_lazy(void)
+{
+	const object *obj;
+	const object *again;
+
+	obj = object_get_binding(CONFIG_CRC_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+
+	/* Probed once, by the first binding */
+	if (obj->flags & OBJECT_FLAG_LAZY) {
+		TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), 0);
+
+		again = object_get_binding(CONFIG_CRC_NAME);
+		TUNIT_ASSERT_PTR_EQUAL(again, obj);
+		TUNIT_ASSERT_EQUAL(object_put(again), 0);
+	}
+
+	TUNIT_ASSERT_EQUAL(object_put(obj), 0);
+	TUNIT_ASSERT_EQUAL(object_put(NULL), -EINVAL);
+}
+#endif
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_lazy_depends(void)
+{
+	const char *const users[] = {
+		CONFIG_TUNIT_LAZY_USER_0_NAME,
+		CONFIG_TUNIT_LAZY_USER_1_NAME,
+		CONFIG_TUNIT_LAZY_USER_2_NAME,
+	};
+	const object *obj;
+	const object *dep;
+	unsigned int i;
+
+	for (i = 0; i < sizeof(users) / sizeof(users[0]); i++) {
+		obj = object_get_binding(users[i]);
+		TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+		TUNIT_ASSERT_EQUAL(object_get_probe_status(obj), 0);
+	}
+
+	/* Probed for the users */
+	TUNIT_ASSERT(tcase_lazy_dep_probe_num > 0);
+
+	/* Each probed user holds it, the binding is ours */
+	dep = object_get_binding(CONFIG_TUNIT_LAZY_DEP_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(dep);
+	TUNIT_ASSERT_EQUAL(object_get_ref_num(dep), (int)i + 1);
+
+	/* Still held by the users, it never goes idle */
+	TUNIT_ASSERT_EQUAL(object_put(dep), 0);
+	TUNIT_ASSERT_EQUAL(object_get_ref_num(dep), (int)i);
+	TUNIT_ASSERT_EQUAL(object_get_probe_status(dep), 0);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_ready(void)
+{
+	const service_t *svc;
+
+	svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(svc);
+	TUNIT_ASSERT_EQUAL(svc->ready, 1);
+
+	/* All the threads entered their loop before the startup event */
+	TUNIT_ASSERT_EQUAL(service_wait_ready(0), 0);
+}
+
+#if defined(CONFIG_BOOT_PROFILE_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_boot_profile(void)
+{
+	boot_profile_record_t record;
+	unsigned int found[BOOT_PROFILE_KIND_NUM];
+	unsigned int num;
+	unsigned int i;
+	int ret;
+
+	(void)memset(found, 0, sizeof(found));
+
+	num = boot_profile_get_num();
+	TUNIT_ASSERT(num > 0);
+
+	for (i = 0; i < num; i++) {
+		ret = boot_profile_read(i, &record);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+		TUNIT_ASSERT_PTR_NOT_NULL_FATAL(record.name);
+
+		if (record.kind < BOOT_PROFILE_KIND_NUM &&
+		    !strcmp(record.name, CONFIG_TUNIT_SERVICE_FOO_NAME))
+			found[record.kind]++;
+	}
+
+	/* The probe of the service and the steps of its initialization */
+	TUNIT_ASSERT_EQUAL(found[BOOT_PROFILE_PROBE], 1);
+	TUNIT_ASSERT_EQUAL(found[BOOT_PROFILE_SERVICE_INIT], 1);
+	TUNIT_ASSERT_EQUAL(found[BOOT_PROFILE_THREAD_CREATE], 1);
+	TUNIT_ASSERT_EQUAL(found[BOOT_PROFILE_QUEUE_CREATE], 1);
+
+	ret = boot_profile_read(num, &record);
+	TUNIT_ASSERT_EQUAL(ret, -ENOENT);
+}
+#endif
+
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_edf(void)
+{
+	static const int deadline_ms[] = { 400, 100, 0, 200 };
+	static const unsigned int order[DEF_EDF_MSG_NUM] = { 1, 3, 0, 2 };
+	const service_t *edf_svc;
+	tcase_service_edf_priv_t *edf_priv_data;
+	service_send_attr_t attr;
+	message_t message;
+	osPriority_t priority;
+	unsigned int late_num;
+	uint32_t now;
+	int i;
+	int ret;
+
+	edf_svc = service_get_binding(CONFIG_TUNIT_SERVICE_EDF_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(edf_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(edf_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	late_num = service_get_late_num(edf_svc);
+
+	/* Keep the receiver away until all the messages are queued */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	now = osKernelGetTickCount();
+	(void)memset(&attr, 0, sizeof(attr));
+
+	for (i = 0; i < DEF_EDF_MSG_NUM; i++) {
+		attr.deadline = deadline_ms[i] ?
+				now + deadline_ms[i] * osKernelGetTickFreq() / 1000 :
+				0;
+
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt_attr(edf_svc, &message, &attr);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	/* Already late, it is dropped */
+	attr.deadline = now - 1;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	ret = service_send_evt_attr(edf_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(edf_svc, SERVICE_LANE_NORMAL),
+			   DEF_EDF_MSG_NUM + 1);
+	TUNIT_ASSERT_EQUAL(service_queue_space(edf_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH -
+			   DEF_EDF_MSG_NUM - 1);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	edf_priv_data = &service_edf_priv;
+
+	TUNIT_ASSERT_EQUAL(edf_priv_data->rcvd_num, DEF_EDF_MSG_NUM);
+
+	/* The messages moved into the heap still count in the lane */
+	for (i = 0; i < DEF_EDF_MSG_NUM; i++) {
+		TUNIT_ASSERT_EQUAL(edf_priv_data->rcvd_param0[i], order[i]);
+		TUNIT_ASSERT_EQUAL(edf_priv_data->rcvd_depth[i],
+				   DEF_EDF_MSG_NUM - 1 - i);
+	}
+
+	TUNIT_ASSERT_EQUAL(service_queue_space(edf_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+
+	TUNIT_ASSERT_EQUAL(service_get_late_num(edf_svc) - late_num, 1);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_edf_full(void)
+{
+	const service_t *edf_svc;
+	service_send_attr_t attr;
+	message_t message;
+	osPriority_t priority;
+	uint32_t now;
+	int i;
+	int ret;
+
+	edf_svc = service_get_binding(CONFIG_TUNIT_SERVICE_EDF_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(edf_svc);
+
+	/* Keep the receiver away until the lane is full */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	now = osKernelGetTickCount();
+	(void)memset(&attr, 0, sizeof(attr));
+	attr.overflow = SERVICE_OVERFLOW_FAIL;
+
+	/* The first one handled, it sleeps with the others in the heap */
+	attr.deadline = now + 100 * osKernelGetTickFreq() / 1000;
+	message.id = MSG_ID_SERVICE_SLEEP_EVT;
+	message.param0 = 50;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt_attr(edf_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	attr.deadline = now + 500 * osKernelGetTickFreq() / 1000;
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	for (i = 1; i < CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH; i++) {
+		ret = service_send_evt_attr(edf_svc, &message, &attr);
+		if (ret)
+			break;
+	}
+
+	TUNIT_ASSERT_EQUAL(ret, 0);
+	TUNIT_ASSERT_EQUAL(service_queue_space(edf_svc, SERVICE_LANE_NORMAL),
+			   0);
+
+	ret = service_send_evt_attr(edf_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, -EPIPE);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, the receiver moves the queue into the heap */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Only the message handled left the lane */
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(edf_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH - 1);
+	TUNIT_ASSERT_EQUAL(service_queue_space(edf_svc, SERVICE_LANE_NORMAL),
+			   1);
+
+	ret = service_send_evt_attr(edf_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	ret = service_send_evt_attr(edf_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, -EPIPE);
+
+	/* Waiting 100ms, for the sleep and the others to be handled */
+	osDelay(100 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(edf_svc, SERVICE_LANE_NORMAL),
+			   0);
+	TUNIT_ASSERT_EQUAL(service_queue_space(edf_svc, SERVICE_LANE_NORMAL),
+			   CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH);
+}
+#endif
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_coalesce(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	osPriority_t priority;
+	unsigned int coalesce_num;
+	unsigned int drop_num;
+	int i;
+	int key;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	coalesce_num = service_get_coalesce_num(foo_svc);
+	drop_num = service_get_coalesce_drop_num(foo_svc);
+
+	/* Keep the receiver away until all the messages are queued */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	for (i = 0; i < DEF_COALESCE_UPDATE_NUM; i++) {
+		for (key = 0; key < DEF_COALESCE_KEY_NUM; key++) {
+			message.id = MSG_ID_SERVICE_LATEST_EVT;
+			message.param0 = key;
+			message.param1 = i;
+			message.ptr = NULL;
+			ret = service_send_evt(foo_svc, &message);
+			TUNIT_ASSERT_EQUAL(ret, 0);
+		}
+	}
+
+	/* One pending message per key */
+	TUNIT_ASSERT_EQUAL(service_get_lane_depth(foo_svc, SERVICE_LANE_NORMAL),
+			   DEF_COALESCE_KEY_NUM);
+	TUNIT_ASSERT_EQUAL(service_get_coalesce_num(foo_svc) - coalesce_num,
+			   DEF_COALESCE_KEY_NUM * (DEF_COALESCE_UPDATE_NUM - 1));
+	TUNIT_ASSERT_EQUAL(service_get_coalesce_drop_num(foo_svc), drop_num);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Every key is handled once, with its last value */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, DEF_COALESCE_KEY_NUM);
+
+	for (key = 0; key < DEF_COALESCE_KEY_NUM; key++) {
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[key].id,
+				   MSG_ID_SERVICE_LATEST_EVT);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[key].param0, key);
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[key].param1,
+				   DEF_COALESCE_UPDATE_NUM - 1);
+	}
+
+	/* A new message of a handled key is queued again */
+	message.id = MSG_ID_SERVICE_LATEST_EVT;
+	message.param0 = 0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, DEF_COALESCE_KEY_NUM + 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[DEF_COALESCE_KEY_NUM].param1,
+			   DEF_MSG_SEND_PARAM_1);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_coalesce_full(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	service_send_attr_t attr;
+	message_t message;
+	osPriority_t priority;
+	unsigned int found = 0;
+	int key;
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Keep the receiver away until all the messages are queued */
+	priority = osThreadGetPriority(osThreadGetId());
+	(void)osThreadSetPriority(osThreadGetId(), osPriorityHigh);
+
+	/* Every slot is taken by the keys 1 to CONFIG_SERVICE_COALESCE_SLOT_NUM */
+	message.id = MSG_ID_SERVICE_LATEST_EVT;
+	for (key = 1; key <= CONFIG_SERVICE_COALESCE_SLOT_NUM; key++) {
+		message.param0 = key;
+		ret = service_send_evt(foo_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	/* Key 0 is queued without a slot */
+	message.param0 = 0;
+	message.param1 = 1;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param1 = 0;
+	while (service_queue_space(foo_svc, SERVICE_LANE_NORMAL) > 0) {
+		ret = service_send_evt(foo_svc, &message);
+		if (ret)
+			break;
+	}
+
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Dropping the token of key 1 frees its slot */
+	(void)memset(&attr, 0, sizeof(attr));
+	attr.overflow = SERVICE_OVERFLOW_DROP_OLDEST;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Key 0 gets a token now, and its value is replaced */
+	message.id = MSG_ID_SERVICE_LATEST_EVT;
+	message.param1 = 2;
+	ret = service_send_evt_attr(foo_svc, &message, &attr);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	message.param1 = 3;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	(void)osThreadSetPriority(osThreadGetId(), priority);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* The copy without a slot keeps its value, the token gets the last */
+	foo_priv_data = &service_foo_priv;
+
+	for (i = 0; i < foo_priv_data->rcvd_num; i++) {
+		if (foo_priv_data->rcvd_message[i].id !=
+		    MSG_ID_SERVICE_LATEST_EVT ||
+		    foo_priv_data->rcvd_message[i].param0)
+			continue;
+
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param1,
+				   found ? 3 : 1);
+		found++;
+	}
+
+	TUNIT_ASSERT_EQUAL(found, 2);
+}
+
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_actor(void)
+{
+	const service_t *baz_svc;
+	tcase_service_baz_priv_t *baz_priv_data;
+	message_t message;
+	message_t rsp_message;
+	int i;
+	int ret;
+
+	baz_svc = service_get_binding(CONFIG_TUNIT_SERVICE_BAZ_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(baz_svc);
+
+	/* The actor is run by the worker pool */
+	TUNIT_ASSERT_PTR_NULL(service_get_thread_id(baz_svc));
+	TUNIT_ASSERT_PTR_NOT_NULL(service_get_queue_id(baz_svc));
+
+	baz_priv_data = &service_baz_priv;
+	(void)memset(baz_priv_data, 0, sizeof(tcase_service_baz_priv_t));
+
+	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt(baz_svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Check the service test result */
+	TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_num, DEF_MAX_MSG_BUFF_NUM);
+
+	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_message[i].id,
+				   MSG_ID_SERVICE_DATA_EVT);
+		TUNIT_ASSERT_EQUAL(baz_priv_data->rcvd_message[i].param0, i);
+	}
+
+	message.id = MSG_ID_SERVICE_DATA_REQ;
+	message.param0 = DEF_MSG_REQ_PARAM_0;
+	message.param1 = DEF_MSG_REQ_PARAM_1;
+	message.ptr = NULL;
+	ret = service_call(baz_svc,
+			   &message,
+			   &rsp_message,
+			   100 * osKernelGetTickFreq() / 1000);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+	TUNIT_ASSERT_EQUAL(rsp_message.id, MSG_ID_SERVICE_DATA_RSP);
+	TUNIT_ASSERT_EQUAL(rsp_message.param0, DEF_MSG_RSP_PARAM_0);
+	TUNIT_ASSERT_EQUAL(rsp_message.param1, DEF_MSG_RSP_PARAM_1);
+
+	/* The other workers must not be left waiting for the actor itself */
+	message.id = MSG_ID_SERVICE_CALL_SELF_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(baz_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(baz_priv_data->call_ret, -EDEADLK);
+
+	/* The actor still serves the calls */
+	message.id = MSG_ID_SERVICE_DATA_REQ;
+	ret = service_call(baz_svc,
+			   &message,
+			   &rsp_message,
+			   100 * osKernelGetTickFreq() / 1000);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+}
+#endif
+
+#if defined(CONFIG_FLIGHT_RECORDER_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_flight_recorder(void)
+{
+	const service_t *foo_svc;
+	flight_record_t record;
+	message_t message;
+	int send_num = 0;
+	int dispatch_num = 0;
+	unsigned int age;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_REQ_PARAM_1;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Other services may record meanwhile, search the recent history */
+	for (age = 0; age < CONFIG_FLIGHT_RECORDER_RECORD_NUM; age++) {
+		if (flight_recorder_read(age, &record))
+			break;
+
+		if (record.id != MSG_ID_SERVICE_DATA_EVT
+		    || record.param0 != DEF_MSG_SEND_PARAM_0
+		    || record.param1 != DEF_MSG_REQ_PARAM_1)
+			continue;
+
+		TUNIT_ASSERT_EQUAL(record.type, MSG_TYPE_EVT);
+		TUNIT_ASSERT_EQUAL(record.src, FLIGHT_RECORD_NO_SERVICE);
+		TUNIT_ASSERT_PTR_EQUAL(service_get_binding_by_index(record.dst),
+				       foo_svc);
+
+		if (record.event == FLIGHT_RECORD_SEND)
+			send_num++;
+		else if (record.event == FLIGHT_RECORD_DISPATCH)
+			dispatch_num++;
+	}
+
+	TUNIT_ASSERT_EQUAL(send_num, 1);
+	TUNIT_ASSERT_EQUAL(dispatch_num, 1);
+
+	ret = flight_recorder_read(CONFIG_FLIGHT_RECORDER_RECORD_NUM, &record);
+	TUNIT_ASSERT_EQUAL(ret, -ENOENT);
+}
+#endif
+
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_stats(void)
+{
+	const service_t *svc;
+	service_stats_t stats;
+	message_t message;
+	unsigned int wait_num;
+	unsigned int run_num;
+	int i;
+	int ret;
+
+	svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(svc);
+
+	service_clear_stats(svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	for (i = 0; i < DEF_MAX_MSG_BUFF_NUM; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_send_evt(svc, &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+	}
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	ret = service_get_stats(svc, &stats);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	TUNIT_ASSERT_EQUAL(stats.handled_num, DEF_MAX_MSG_BUFF_NUM + 1);
+	TUNIT_ASSERT_EQUAL(stats.drop_num, 0);
+	TUNIT_ASSERT(stats.queue_high_water >= 1);
+	TUNIT_ASSERT(stats.queue_high_water <=
+		     CONFIG_SERVICE_DEFAULT_QUEUE_LENGTH +
+		     CONFIG_SERVICE_DEFAULT_URGENT_QUEUE_LENGTH);
+
+	wait_num = 0;
+	run_num = 0;
+	for (i = 0; i < CONFIG_SERVICE_STATS_HIST_NUM; i++) {
+		wait_num += stats.wait_hist[i];
+		run_num += stats.run_hist[i];
+	}
+
+	/* Every message waits once, the handler runs once per message */
+	TUNIT_ASSERT_EQUAL(wait_num, DEF_MAX_MSG_BUFF_NUM + 1);
+	TUNIT_ASSERT_EQUAL(run_num, DEF_MAX_MSG_BUFF_NUM + 1);
+
+	ret = service_get_stats(NULL, &stats);
+	TUNIT_ASSERT_EQUAL(ret, -EINVAL);
+}
+#endif
+
+#if defined(CONFIG_LED_SERVICE_STATIC_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_static(void)
+{
+	const service_t *led_svc;
+	const object *obj;
+	const service_config_t *config;
+
+	obj = object_get_binding(CONFIG_LED_SERVICE_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(obj);
+
+	led_svc = (const service_t *)obj->object_data;
+	TUNIT_ASSERT_PTR_NOT_NULL(service_get_thread_id(led_svc));
+	TUNIT_ASSERT_PTR_NOT_NULL(service_get_queue_id(led_svc));
+
+	/* The control blocks and storage are reserved at link time */
+	config = (const service_config_t *)obj->object_config;
+	TUNIT_ASSERT_PTR_NOT_EQUAL(config, &service_config_default);
+	TUNIT_ASSERT_PTR_NOT_NULL(config->thread_attr.cb_mem);
+	TUNIT_ASSERT_PTR_NOT_NULL(config->thread_attr.stack_mem);
+	TUNIT_ASSERT_PTR_NOT_NULL(config->queue_attr.mq_mem);
+	TUNIT_ASSERT_PTR_NOT_NULL(config->urgent_queue_attr.mq_mem);
+
+	TUNIT_ASSERT_EQUAL(osMessageQueueGetCapacity(
+				   service_get_queue_id(led_svc)),
+			   CONFIG_LED_SERVICE_QUEUE_LENGTH);
+}
+#endif
+
+#if defined(CONFIG_LED_SERVICE_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_dispatch(void)
+{
+	const service_t *foo_svc;
+	const service_t *led_svc;
+	message_t message;
+	int ret;
+
+	led_svc = service_get_binding(CONFIG_LED_SERVICE_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(led_svc);
+
+	/* The LED service only handles the IDs of its dispatch table */
+	TUNIT_ASSERT_PTR_EQUAL(led_svc->handle_message, NULL);
+	TUNIT_ASSERT_PTR_NOT_NULL(led_svc->dispatch);
+	TUNIT_ASSERT(service_is_handled(led_svc, MSG_ID_LED_START));
+	TUNIT_ASSERT(service_is_handled(led_svc, MSG_ID_LED_STOP));
+	TUNIT_ASSERT(!service_is_handled(led_svc,
+					 MSG_ID_LED_PATTERN_COMPLETED));
+	TUNIT_ASSERT(!service_is_handled(led_svc,
+					 MSG_ID_SYS_STARTUP_COMPLETED));
+
+	message.id = MSG_ID_LED_PATTERN_COMPLETED;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(led_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+
+	/* A service with handle_message takes all the IDs */
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+	TUNIT_ASSERT(service_is_handled(foo_svc,
+					MSG_ID_LED_PATTERN_COMPLETED));
+}
+#endif
+
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_inline(void)
+{
+	static const char text[] = "inline payload";
+	unsigned char data[CONFIG_SERVICE_INLINE_MAX_SIZE + 1];
+	const service_t *foo_svc;
+	const service_t *baz_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	foo_priv_data = &service_foo_priv;
+
+	message.id = MSG_ID_SERVICE_INLINE_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = NULL;
+	ret = service_send_evt_inline(foo_svc, &message, text, sizeof(text));
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->inline_size, sizeof(text));
+	TUNIT_ASSERT_STRING_EQUAL((const char *)foo_priv_data->inline_data,
+				  text);
+
+	/* Larger than the inline maximum */
+	(void)memset(data, 0, sizeof(data));
+	ret = service_send_evt_inline(foo_svc, &message, data, sizeof(data));
+	TUNIT_ASSERT_EQUAL(ret, -EINVAL);
+
+	/* Empty payloads are allowed */
+	ret = service_send_evt_inline(foo_svc, &message, NULL, 0);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 2);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->inline_size, 0);
+
+	/* The service has no inline queue */
+	baz_svc = service_get_binding(CONFIG_TUNIT_SERVICE_BAZ_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(baz_svc);
+
+	ret = service_send_evt_inline(baz_svc, &message, text, sizeof(text));
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+	TUNIT_ASSERT_EQUAL(service_get_inline_drop_num(foo_svc), 0);
+}
+#endif
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_transport(void)
+{
+	const service_t *foo_svc;
+	const service_t *proxy_svc;
+	const object *transport;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	message_t rsp_message;
+	unsigned int send_num;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	proxy_svc = service_get_binding(CONFIG_TUNIT_SERVICE_PROXY_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(proxy_svc);
+
+	transport = object_get_binding(CONFIG_TUNIT_TRANSPORT_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(transport);
+
+	TUNIT_ASSERT(service_is_remote(proxy_svc));
+	TUNIT_ASSERT(!service_is_remote(foo_svc));
+	TUNIT_ASSERT_PTR_NULL(service_get_thread_id(proxy_svc));
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	send_num = service_remote_get_send_num(proxy_svc);
+
+	/* The proxy passes the event through the transport */
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = NULL;
+	ret = service_send_evt(proxy_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+	TUNIT_ASSERT_EQUAL(service_remote_get_send_num(proxy_svc),
+			   send_num + 1);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].id,
+			   MSG_ID_SERVICE_DATA_EVT);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].param0,
+			   DEF_MSG_SEND_PARAM_0);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].param1,
+			   DEF_MSG_SEND_PARAM_1);
+
+	/* Pointers and calls do not cross the transport */
+	message.ptr = &message;
+	ret = service_send_evt(proxy_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+
+	message.ptr = NULL;
+	ret = service_call(proxy_svc, &message, &rsp_message, 10);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+
+	/* Unknown services of the peer are refused */
+	ret = service_transport_deliver(transport,
+					object_hash_name("no such service"),
+					0,
+					MSG_TYPE_EVT,
+					&message);
+	TUNIT_ASSERT_EQUAL(ret, -ENOENT);
+
+	/* A request needs the proxy of its source */
+	ret = service_transport_deliver(transport,
+					object_hash_name(
+						CONFIG_TUNIT_SERVICE_FOO_NAME),
+					object_hash_name("no such service"),
+					MSG_TYPE_REQ,
+					&message);
+	TUNIT_ASSERT_EQUAL(ret, -ENOENT);
+}
+#endif
+
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE) \
+	&& defined(CONFIG_SERVICE_BRIDGE_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_bridge(void)
+{
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	service_bridge_frame_t frame;
+	message_t message;
+	unsigned int rx_num;
+	unsigned int error_num;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	rx_num = service_bridge_get_rx_num();
+	error_num = service_bridge_get_error_num();
+
+	/* A frame from the host is delivered as a local send */
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	ret = service_bridge_encode(&frame,
+				    object_hash_name(
+					    CONFIG_TUNIT_SERVICE_FOO_NAME),
+				    0,
+				    MSG_TYPE_EVT,
+				    &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	ret = service_bridge_decode(&frame);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+	TUNIT_ASSERT_EQUAL(service_bridge_get_rx_num(), rx_num + 1);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].id,
+			   MSG_ID_SERVICE_DATA_EVT);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].param0,
+			   DEF_MSG_SEND_PARAM_0);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[0].param1,
+			   DEF_MSG_SEND_PARAM_1);
+
+	/* A corrupted frame is refused */
+	frame.param0 ^= 0x01;
+	ret = service_bridge_decode(&frame);
+	TUNIT_ASSERT_EQUAL(ret, -EIO);
+	TUNIT_ASSERT_EQUAL(service_bridge_get_error_num(), error_num + 1);
+
+	/* A frame for an unknown service is refused */
+	ret = service_bridge_encode(&frame,
+				    object_hash_name("no such service"),
+				    0,
+				    MSG_TYPE_EVT,
+				    &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	ret = service_bridge_decode(&frame);
+	TUNIT_ASSERT_EQUAL(ret, -ENOENT);
+	TUNIT_ASSERT_EQUAL(service_bridge_get_error_num(), error_num + 2);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 1);
+}
+#endif
+
+#if defined(CONFIG_SERVICE_TIMER_ENABLE)
+#define DEF_TIMER_NUM 4
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_timer(void)
+{
+	static service_timer_t timer[DEF_TIMER_NUM];
+	static service_timer_t far_timer;
+	static const unsigned int timeout_ms[DEF_TIMER_NUM] = { 30, 10, 20, 15 };
+	static const unsigned int order[DEF_TIMER_NUM - 1] = { 1, 2, 0 };
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	message_t message;
+	unsigned int active_num;
+	int i;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	active_num = service_timer_get_active_num();
+
+	for (i = 0; i < DEF_TIMER_NUM; i++) {
+		message.id = MSG_ID_SERVICE_DATA_EVT;
+		message.param0 = i;
+		message.param1 = DEF_MSG_SEND_PARAM_1;
+		message.ptr = NULL;
+		ret = service_timer_start(&timer[i],
+					  foo_svc,
+					  timeout_ms[i],
+					  &message);
+		TUNIT_ASSERT_EQUAL(ret, 0);
+		TUNIT_ASSERT(service_timer_is_active(&timer[i]));
+	}
+
+	/* Far enough to sit in an upper level of the wheel */
+	ret = service_timer_start(&far_timer, foo_svc, 100000, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	TUNIT_ASSERT_EQUAL(service_timer_get_active_num() - active_num,
+			   DEF_TIMER_NUM + 1);
+
+	ret = service_timer_stop(&timer[DEF_TIMER_NUM - 1]);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	ret = service_timer_stop(&far_timer);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	ret = service_timer_stop(&far_timer);
+	TUNIT_ASSERT_EQUAL(ret, -EPERM);
+
+	/* Waiting 50ms, for the timers to expire */
+	osDelay(50 * osKernelGetTickFreq() / 1000);
+
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, DEF_TIMER_NUM - 1);
+
+	for (i = 0; i < DEF_TIMER_NUM - 1; i++)
+		TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[i].param0,
+				   order[i]);
+
+	for (i = 0; i < DEF_TIMER_NUM; i++)
+		TUNIT_ASSERT(!service_timer_is_active(&timer[i]));
+
+	TUNIT_ASSERT_EQUAL(service_timer_get_active_num(), active_num);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_timer_full(void)
+{
+	static service_timer_t timer;
+	const service_t *foo_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	osThreadId_t thread_id;
+	message_t message;
+	unsigned int retry_num;
+	unsigned int drop_num;
+	int queued = 0;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	thread_id = service_get_thread_id(foo_svc);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(thread_id);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	retry_num = service_timer_get_retry_num();
+	drop_num = service_timer_get_drop_num();
+
+	/* The receiver is kept away, its queue stays full */
+	TUNIT_ASSERT_EQUAL_FATAL(osThreadSuspend(thread_id), osOK);
+
+	message.id = MSG_ID_SERVICE_DATA_EVT;
+	while (service_queue_space(foo_svc, SERVICE_LANE_NORMAL) > 0) {
+		ret = service_send_evt(foo_svc, &message);
+		if (ret)
+			break;
+		queued++;
+	}
+
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	ret = service_timer_start(&timer, foo_svc, 10, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 30ms, the expiry is refused and kept */
+	osDelay(30 * osKernelGetTickFreq() / 1000);
+
+	TUNIT_ASSERT(service_timer_get_retry_num() > retry_num);
+	TUNIT_ASSERT(service_timer_is_active(&timer));
+
+	(void)osThreadResume(thread_id);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* The expiry comes after the queued messages, it is not lost */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, queued + 1);
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_message[queued].param0,
+			   DEF_MSG_SEND_PARAM_0);
+	TUNIT_ASSERT(!service_timer_is_active(&timer));
+	TUNIT_ASSERT_EQUAL(service_timer_get_drop_num(), drop_num);
+}
+#endif
+
+#if defined(CONFIG_MSG_PAYLOAD_POOL_ENABLE)
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_service_check_payload_broadcast(void)
+{
+	const service_t *foo_svc;
+	const service_t *bar_svc;
+	tcase_service_foo_priv_t *foo_priv_data;
+	tcase_service_bar_priv_t *bar_priv_data;
+	message_t message;
+	unsigned int free_num;
+	unsigned int *payload;
+	int ret;
+
+	foo_svc = service_get_binding(CONFIG_TUNIT_SERVICE_FOO_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(foo_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(foo_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	bar_svc = service_get_binding(CONFIG_TUNIT_SERVICE_BAR_NAME);
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(bar_svc);
+
+	message.id = MSG_ID_SERVICE_INIT_EVT;
+	message.param0 = 0;
+	message.param1 = 0;
+	message.ptr = NULL;
+	ret = service_send_evt(bar_svc, &message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	free_num = message_payload_get_free_num();
+
+	payload = message_payload_alloc(sizeof(unsigned int));
+	TUNIT_ASSERT_PTR_NOT_NULL_FATAL(payload);
+	TUNIT_ASSERT_EQUAL(message_payload_get_free_num(), free_num - 1);
+
+	*payload = DEF_MSG_SEND_PARAM_0;
+
+	message.id = MSG_ID_SERVICE_DATA_BROADCAST;
+	message.param0 = DEF_MSG_SEND_PARAM_0;
+	message.param1 = DEF_MSG_SEND_PARAM_1;
+	message.ptr = payload;
+	ret = service_broadcast_evt(&message);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* The receivers keep the payload alive after the sender drops it */
+	ret = message_payload_put(payload);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* Waiting 10ms, for server async processing messages */
+	osDelay(10 * osKernelGetTickFreq() / 1000);
+
+	/* Check the service test result */
+	foo_priv_data = &service_foo_priv;
+
+	TUNIT_ASSERT_EQUAL(foo_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_PTR_EQUAL(foo_priv_data->rcvd_message[0].ptr, payload);
+
+	bar_priv_data = &service_bar_priv;
+
+	TUNIT_ASSERT_EQUAL(bar_priv_data->rcvd_num, 1);
+	TUNIT_ASSERT_PTR_EQUAL(bar_priv_data->rcvd_message[0].ptr, payload);
+
+	/* The last receiver returned the payload to the pool */
+	TUNIT_ASSERT_EQUAL(message_payload_get_free_num(), free_num);
+}
+#endif
+
+define_tunit_suit(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  tcase_suit_initialize,
+		  tcase_suit_cleanup);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check structure test",
+		  tcace_service_check_structure);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check binding by id",
+		  tcace_service_check_binding_by_id);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check queue attr test",
+		  tcace_service_check_queue_attr);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check thread attr test",
+		  tcace_service_check_thread_attr);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check single queue evt",
+		  tcace_service_check_single_queue_evt);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check multi queue evt",
+		  tcace_service_check_multi_queue_evt);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check multi queue request",
+		  tcace_service_check_multi_queue_req);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check broadcast evt",
+		  tcace_service_check_broadcast_evt);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check broadcast subscribe",
+		  tcace_service_check_broadcast_subscribe);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check batch evt",
+		  tcace_service_check_batch_evt);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check urgent lane",
+		  tcace_service_check_urgent_lane);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check call",
+		  tcace_service_check_call);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check isr evt",
+		  tcace_service_check_isr_evt);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check overflow",
+		  tcace_service_check_overflow);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check coalesce",
+		  tcace_service_check_coalesce);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check coalesce full",
+		  tcace_service_check_coalesce_full);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check probe status",
+		  tcace_service_check_probe_status);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check probe workers",
+		  tcace_service_check_probe_workers);
+#if defined(CONFIG_CRC_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check lazy",
+		  tcace_service_check_lazy);
+#endif
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check lazy depends",
+		  tcace_service_check_lazy_depends);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check ready",
+		  tcace_service_check_ready);
+#if defined(CONFIG_BOOT_PROFILE_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check boot profile",
+		  tcace_service_check_boot_profile);
+#endif
+#if defined(CONFIG_SERVICE_EDF_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check edf",
+		  tcace_service_check_edf);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check edf full",
+		  tcace_service_check_edf_full);
+#endif
+#if defined(CONFIG_SERVICE_ACTOR_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check actor",
+		  tcace_service_check_actor);
+#endif
+#if defined(CONFIG_FLIGHT_RECORDER_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check flight recorder",
+		  tcace_service_check_flight_recorder);
+#endif
+#if defined(CONFIG_SERVICE_STATS_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check stats",
+		  tcace_service_check_stats);
+#endif
+#if defined(CONFIG_LED_SERVICE_STATIC_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check static",
+		  tcace_service_check_static);
+#endif
+#if defined(CONFIG_LED_SERVICE_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check dispatch",
+		  tcace_service_check_dispatch);
+#endif
+#if defined(CONFIG_SERVICE_INLINE_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check inline",
+		  tcace_service_check_inline);
+#endif
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check transport",
+		  tcace_service_check_transport);
+#endif
+#if defined(CONFIG_SERVICE_TRANSPORT_ENABLE) \
+	&& defined(CONFIG_SERVICE_BRIDGE_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check bridge",
+		  tcace_service_check_bridge);
+#endif
+#if defined(CONFIG_SERVICE_TIMER_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check timer",
+		  tcace_service_check_timer);
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check timer full",
+		  tcace_service_check_timer_full);
+#endif
+#if defined(CONFIG_MSG_PAYLOAD_POOL_ENABLE)
+define_tunit_case(CONFIG_TUNIT_SERVICE_SUIT_NAME,
+		  CONFIG_TUNIT_SERVICE_SUIT_LABEL,
+		  "Service check payload broadcast",
+		  tcace_service_check_payload_broadcast);
+#endif
 
 #endif /* CONFIG_TUNIT_SERVICE_SUIT_NAME */
@@ -0,0 +1,167 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "err.h"
+#include "dbg_trace.h"
+#include "tunit.h"
+
+#if defined(CONFIG_TUNIT_DBG_TRACE_SUIT_NAME) \
+	&& defined(CONFIG_DBG_TRACE_ENABLE) \
+	&& defined(CONFIG_DBG_TRACE_DEFERRED_ENABLE)
+
+#define DEF_DBG_TRACE_BUFF_LEN 128
+
+/**
+ * @brief   Suite initialization function.
+ *
+ * @param   None.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int tcase_suit_initialize(void)
+{
+	return 0;
+}
+
+/**
+ * @brief   Suite cleanup function.
+ *
+ * @param   None.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static int tcase_suit_cleanup(void)
+{
+	return 0;
+}
+
+/**
+ * @brief   Store the format and the arguments into a record.
+ *
+ * @param   record Pointer to the record.
+ * @param   format The format string.
+ *
+ * @retval  Returns the result of dbg_trace_record().
+ */
+static int tcase_dbg_trace_record(dbg_trace_record_t *record,
+				  const char *format, ...)
+{
+	va_list args;
+	int ret;
+
+	va_start(args, format);
+	ret = dbg_trace_record(record, format, args);
+	va_end(args);
+
+	return ret;
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_dbg_trace_format(void)
+{
+	static const char format[] =
+		"[%s][%d] %5d|%-4x|%.3s|%%|%c|%08X|%s";
+	dbg_trace_record_t record;
+	char expected[DEF_DBG_TRACE_BUFF_LEN];
+	char buff[DEF_DBG_TRACE_BUFF_LEN];
+	char str[8];
+	int len;
+	int ret;
+
+	(void)strcpy(str, "hello");
+
+	ret = tcase_dbg_trace_record(&record, format, "func", 12,
+				     42, 0xab, str, 'z', 0xbeef, "end");
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	/* The string on the stack is copied, it may change before the format */
+	(void)strcpy(str, "world");
+
+	len = dbg_trace_format(&record, buff, sizeof(buff));
+	(void)snprintf(expected, sizeof(expected), format, "func", 12,
+		       42, 0xab, "hello", 'z', 0xbeef, "end");
+	TUNIT_ASSERT_STRING_EQUAL(buff, expected);
+	TUNIT_ASSERT_EQUAL(len, strlen(expected));
+
+	/* The output is cut to the buffer */
+	ret = tcase_dbg_trace_record(&record, "abc%d", 123456789);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+
+	len = dbg_trace_format(&record, buff, 8);
+	TUNIT_ASSERT_STRING_EQUAL(buff, "abc1234");
+	TUNIT_ASSERT_EQUAL(len, 7);
+}
+
+/**
+ * @brief   Testing function in a test case.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ */
+static void tcace_dbg_trace_fallback(void)
+{
+	dbg_trace_record_t record;
+	char str[CONFIG_DBG_TRACE_STR_SIZE + 1];
+	int ret;
+
+	/* Formatted in the caller, the specification is not deferred */
+	ret = tcase_dbg_trace_record(&record, "%ld", 1L);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+
+	ret = tcase_dbg_trace_record(&record, "%*d", 4, 1);
+	TUNIT_ASSERT_EQUAL(ret, -ENOSUPPORT);
+
+	/* Formatted in the caller, the arguments do not fit the record */
+	ret = tcase_dbg_trace_record(&record, "%d %d %d %d %d %d %d %d %d",
+				     1, 2, 3, 4, 5, 6, 7, 8, 9);
+	TUNIT_ASSERT_EQUAL(ret, -E2BIG);
+
+	(void)memset(str, 'a', sizeof(str) - 1);
+	str[sizeof(str) - 1] = '\0';
+	ret = tcase_dbg_trace_record(&record, "%s", str);
+	TUNIT_ASSERT_EQUAL(ret, -E2BIG);
+
+	/* Only the precision of the string is copied */
+	ret = tcase_dbg_trace_record(&record, "%.4s", str);
+	TUNIT_ASSERT_EQUAL(ret, 0);
+}
+
+define_tunit_suit(CONFIG_TUNIT_DBG_TRACE_SUIT_NAME,
+		  CONFIG_TUNIT_DBG_TRACE_SUIT_LABEL,
+		  tcase_suit_initialize,
+		  tcase_suit_cleanup);
+define_tunit_case(CONFIG_TUNIT_DBG_TRACE_SUIT_NAME,
+		  CONFIG_TUNIT_DBG_TRACE_SUIT_LABEL,
+		  "Dbg trace deferred format test",
+		  tcace_dbg_trace_format);
+define_tunit_case(CONFIG_TUNIT_DBG_TRACE_SUIT_NAME,
+		  CONFIG_TUNIT_DBG_TRACE_SUIT_LABEL,
+		  "Dbg trace caller format fallback test",
+		  tcace_dbg_trace_fallback);
+
+#endif /* CONFIG_TUNIT_DBG_TRACE_SUIT_NAME */
@@ -0,0 +1,142 @@
+#!/usr/bin/python
+
+# Host peer of the service bridge, see framework/include/service_bridge.h.
+#
+# The services of the device are named by their name, as in the
+# DECLARE_SERVICE() of the firmware. Host services are plain names too,
+# the device reaches them through DECLARE_REMOTE_SERVICE() proxies.
+
+import argparse
+import struct
+import sys
+import time
+
+import serial
+
+SYNC = b"\xa5\x5a"
+
+# sync, seq, type, dst_hash, src_hash, id, param0, param1, crc
+FRAME = struct.Struct("<2sBBIIIIII")
+
+MSG_TYPES = {"req": 0, "rsp": 1, "evt": 2}
+MSG_TYPE_NAMES = dict((v, k) for k, v in MSG_TYPES.items())
+
+def hash_name(name):
+	# object_hash_name() of the firmware, 32 bits FNV-1a
+	h = 2166136261
+	for c in name.encode("ascii"):
+		h = ((h ^ c) * 16777619) & 0xffffffff
+	return h
+
+def crc32_words(data):
+	# CRC unit of the device: polynomial 0x04C11DB7, initial value
+	# 0xFFFFFFFF, no reflection, fed with little endian words
+	crc = 0xffffffff
+	for (word,) in struct.iter_unpack("<I", data):
+		crc ^= word
+		for i in range(32):
+			if crc & 0x80000000:
+				crc = ((crc << 1) ^ 0x04c11db7) & 0xffffffff
+			else:
+				crc = (crc << 1) & 0xffffffff
+	return crc
+
+def encode(seq, msg_type, dst, src, msg_id, param0, param1):
+	frame = FRAME.pack(SYNC, seq & 0xff, msg_type, hash_name(dst),
+			   hash_name(src) if src else 0,
+			   msg_id, param0, param1, 0)
+	return frame[:-4] + struct.pack("<I", crc32_words(frame[:-4]))
+
+def decode(buff):
+	# Returns the frames found in buff and the bytes left over
+	frames = []
+	while True:
+		start = buff.find(SYNC)
+		if start < 0:
+			return frames, buff[-1:] if buff[-1:] == SYNC[:1] else b""
+		buff = buff[start:]
+		if len(buff) < FRAME.size:
+			return frames, buff
+		fields = FRAME.unpack(buff[:FRAME.size])
+		if crc32_words(buff[:FRAME.size - 4]) != fields[-1]:
+			buff = buff[1:]
+			continue
+		frames.append(fields)
+		buff = buff[FRAME.size:]
+
+def show(fields, names):
+	_, seq, msg_type, dst, src, msg_id, param0, param1, _ = fields
+	print("#{:3d} {} {} -> {} id 0x{:08x} 0x{:08x} 0x{:08x}".format(
+		seq, MSG_TYPE_NAMES.get(msg_type, msg_type),
+		names.get(src, "0x{:08x}".format(src)),
+		names.get(dst, "0x{:08x}".format(dst)),
+		msg_id, param0, param1))
+
+def monitor(port, args):
+	names = dict((hash_name(n), n) for n in args.names)
+	buff = b""
+	while True:
+		data = port.read(256)
+		if not data:
+			continue
+		frames, buff = decode(buff + data)
+		for fields in frames:
+			show(fields, names)
+
+def send(port, args):
+	port.write(encode(0, MSG_TYPES[args.type], args.dst, args.src,
+			  args.id, args.param0, args.param1))
+	port.flush()
+
+def load(port, args):
+	start = time.time()
+	for seq in range(args.count):
+		port.write(encode(seq, MSG_TYPES[args.type], args.dst, args.src,
+				  args.id, seq, args.param1))
+	port.flush()
+	elapsed = time.time() - start
+	print("{} frames in {:.3f}s, {:.0f} frames/s".format(
+		args.count, elapsed, args.count / elapsed if elapsed else 0))
+
+def main():
+	parser = argparse.ArgumentParser(description="Service bridge host peer.")
+	parser.add_argument("-p", "--port", required=True, help="Serial port")
+	parser.add_argument("-b", "--baudrate", type=int, default=115200)
+	sub = parser.add_subparsers(dest="command")
+
+	cmd = sub.add_parser("monitor", help="Print the frames of the device")
+	cmd.add_argument("names", nargs="*", help="Service names to show")
+	cmd.set_defaults(func=monitor)
+
+	for name, func, text in (("send", send, "Send one message"),
+				 ("load", load, "Send messages at wire speed")):
+		cmd = sub.add_parser(name, help=text)
+		cmd.add_argument("dst", help="Destination service name")
+		cmd.add_argument("id", type=lambda x: int(x, 0), help="Message ID")
+		cmd.add_argument("param0", type=lambda x: int(x, 0), nargs="?",
+				 default=0)
+		cmd.add_argument("param1", type=lambda x: int(x, 0), nargs="?",
+				 default=0)
+		cmd.add_argument("-s", "--src", help="Source service name")
+		cmd.add_argument("-t", "--type", choices=MSG_TYPES, default="evt")
+		if name == "load":
+			cmd.add_argument("-n", "--count", type=int, default=1000)
+		cmd.set_defaults(func=func)
+
+	args = parser.parse_args()
+	if not args.command:
+		parser.print_help()
+		return 1
+
+	port = serial.Serial(args.port, args.baudrate, timeout=0.1)
+	try:
+		args.func(port, args)
+	except KeyboardInterrupt:
+		pass
+	finally:
+		port.close()
+
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())
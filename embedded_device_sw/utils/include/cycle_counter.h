@@ -0,0 +1,54 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#include <stdint.h>
+#include "bsp_conf.h"
+#include CONFIG_CMSIS_DEVICE_HEADER
+
+/**
+ * @brief   Start the DWT cycle counter.
+ *
+ * @param   None.
+ *
+ * @retval  None.
+ *
+ * @note    Shared by the boot profile and the service statistics, it is
+ *          never stopped, so calling it again is harmless.
+ */
+static inline void cycle_counter_start(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * @brief   Read the DWT cycle counter.
+ *
+ * @param   None.
+ *
+ * @retval  Returns the number of cycles, it wraps after 2^32 cycles.
+ */
+static inline uint32_t cycle_counter_read(void)
+{
+	return DWT->CYCCNT;
+}
+
+#endif /* __CYCLE_COUNTER_H__ */
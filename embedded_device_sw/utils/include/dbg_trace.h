@@ -19,6 +19,40 @@
 #ifndef __DBG_TRACE_H__
 #define __DBG_TRACE_H__
 
+#include <stdarg.h>
+#include "utils_conf.h"
+
+#if defined(CONFIG_DBG_TRACE_ENABLE) \
+	&& defined(CONFIG_DBG_TRACE_DEFERRED_ENABLE)
+/**
+ * @brief   Dbg trace argument definition.
+ */
+typedef union {
+	unsigned int	value;
+	const void *	ptr;
+} dbg_trace_arg_t;
+
+/**
+ * @brief   Dbg trace record definition.
+ *
+ * The arguments are stored raw, they are formatted by the trace thread.
+ * The '%s' strings outside the read only image are copied into str, the
+ * bit of their argument is set in copied and value is their offset.
+ */
+typedef struct {
+	const char *	format;
+	dbg_trace_arg_t arg[CONFIG_DBG_TRACE_ARG_NUM];
+	unsigned int	copied;
+	char		str[CONFIG_DBG_TRACE_STR_SIZE];
+} dbg_trace_record_t;
+
+extern int dbg_trace_record(dbg_trace_record_t *record, const char *format,
+			    va_list args);
+extern int dbg_trace_format(const dbg_trace_record_t *	record,
+			    char *			buff,
+			    int				size);
+#endif
+
 extern int dbg_trace_output(const char *format, ...);
 
 #endif /* __DBG_TRACE_H__ */
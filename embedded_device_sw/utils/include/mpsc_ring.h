@@ -0,0 +1,228 @@
+/**
+ * Embedded Device Software
+ * Copyright (C) 2020 Peter.Peng
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MPSC_RING_H__
+#define __MPSC_RING_H__
+
+#include <stdint.h>
+#include <string.h>
+#include "cmsis_compiler.h"
+#include "err.h"
+
+/**
+ * @brief   Lock-free multi-producer single-consumer ring definition.
+ *
+ * Producers may be interrupt handlers of any priority, they claim a slot
+ * with LDREX/STREX and publish it through the slot sequence number.
+ * Only one thread may read the ring.
+ */
+typedef struct {
+	volatile uint32_t	head;
+	uint32_t		tail;
+	uint32_t		size;
+	uint32_t		elem_size;
+	uint32_t		slot_words;
+	volatile uint32_t	drop_num;
+	uint32_t *		buffer;
+} mpsc_ring_t;
+
+/**
+ * @brief   Number of words of a slot, the sequence number and the element.
+ */
+#define MPSC_RING_SLOT_WORDS(elem_size) (1 + ((elem_size) + 3) / 4)
+
+/**
+ * @brief   Define the storage of a ring in an initializer.
+ *
+ * @note    length must be a power of two.
+ */
+#define MPSC_RING_INITIALIZER(length, elem_size) \
+	{ \
+		.size	= (length), \
+		.buffer = (uint32_t[(length) * \
+				    MPSC_RING_SLOT_WORDS(elem_size)]){ 0 } \
+	}
+
+/**
+ * @brief   Get the slot of a position.
+ *
+ * @param   ring Pointer to the ring handle.
+ * @param   pos The position.
+ *
+ * @retval  Returns the pointer to the slot.
+ */
+static inline uint32_t *mpsc_ring_slot(mpsc_ring_t *ring, uint32_t pos)
+{
+	return &ring->buffer[(pos & (ring->size - 1)) * ring->slot_words];
+}
+
+/**
+ * @brief   Atomically increase a counter.
+ *
+ * @param   counter Pointer to the counter.
+ *
+ * @retval  None.
+ */
+static inline void mpsc_ring_atomic_inc(volatile uint32_t *counter)
+{
+	uint32_t value;
+
+	do
+		value = __LDREXW(counter);
+	while (__STREXW(value + 1, counter));
+}
+
+/**
+ * @brief   Write an element, it can be called from interrupt handlers.
+ *
+ * @param   ring Pointer to the ring handle.
+ * @param   elem Pointer to the element to write.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int mpsc_ring_write(mpsc_ring_t *ring, const void *elem)
+{
+	uint32_t *slot;
+	uint32_t pos;
+	int32_t diff;
+
+	if (!ring)
+		return -EINVAL;
+
+	if (!ring->buffer)
+		return -EINVAL;
+
+	while (1) {
+		pos = __LDREXW(&ring->head);
+		slot = mpsc_ring_slot(ring, pos);
+		diff = (int32_t)(*(volatile uint32_t *)slot - pos);
+
+		if (diff < 0) {
+			__CLREX();
+			mpsc_ring_atomic_inc(&ring->drop_num);
+			return -EFULL;
+		}
+
+		/* Another producer claimed the slot, reload the head */
+		if (diff > 0) {
+			__CLREX();
+			continue;
+		}
+
+		if (!__STREXW(pos + 1, &ring->head))
+			break;
+	}
+
+	memcpy(&slot[1], elem, ring->elem_size);
+
+	__DMB();
+	*(volatile uint32_t *)slot = pos + 1;
+
+	return 0;
+}
+
+/**
+ * @brief   Read an element, only one thread may read the ring.
+ *
+ * @param   ring Pointer to the ring handle.
+ * @param   elem Pointer to the element to read.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int mpsc_ring_read(mpsc_ring_t *ring, void *elem)
+{
+	uint32_t *slot;
+	uint32_t pos;
+
+	if (!ring)
+		return -EINVAL;
+
+	if (!ring->buffer)
+		return -EINVAL;
+
+	pos = ring->tail;
+	slot = mpsc_ring_slot(ring, pos);
+
+	if (*(volatile uint32_t *)slot != pos + 1)
+		return -EEMPTY;
+
+	__DMB();
+	memcpy(elem, &slot[1], ring->elem_size);
+
+	__DMB();
+	*(volatile uint32_t *)slot = pos + ring->size;
+	ring->tail = pos + 1;
+
+	return 0;
+}
+
+/**
+ * @brief   Check whether the ring has no published element.
+ *
+ * @param   ring Pointer to the ring handle.
+ *
+ * @retval  Returns 1 if the ring is empty, 0 otherwise.
+ */
+static inline int mpsc_ring_is_empty(mpsc_ring_t *ring)
+{
+	return *(volatile uint32_t *)mpsc_ring_slot(ring, ring->tail) !=
+	       ring->tail + 1;
+}
+
+/**
+ * @brief   Initialize the ring.
+ *
+ * @param   ring Pointer to the ring handle.
+ * @param   buffer The buffer space, size * MPSC_RING_SLOT_WORDS(elem_size)
+ *          words.
+ * @param   size The number of elements, must be a power of two.
+ * @param   elem_size The element size in bytes.
+ *
+ * @retval  Returns 0 on success, negative error code otherwise.
+ */
+static inline int mpsc_ring_init(mpsc_ring_t *	ring,
+				 uint32_t *	buffer,
+				 uint32_t	size,
+				 uint32_t	elem_size)
+{
+	uint32_t pos;
+
+	if (!ring)
+		return -EINVAL;
+
+	if (!buffer)
+		return -EINVAL;
+
+	if (!size || (size & (size - 1)))
+		return -EINVAL;
+
+	ring->head = 0;
+	ring->tail = 0;
+	ring->size = size;
+	ring->elem_size = elem_size;
+	ring->slot_words = MPSC_RING_SLOT_WORDS(elem_size);
+	ring->drop_num = 0;
+	ring->buffer = buffer;
+
+	for (pos = 0; pos < size; pos++)
+		*mpsc_ring_slot(ring, pos) = pos;
+
+	return 0;
+}
+
+#endif /* __MPSC_RING_H__ */
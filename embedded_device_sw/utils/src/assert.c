@@ -22,6 +22,7 @@
 #include "cmsis_os2.h"
 #include "object.h"
 #include "err.h"
+#include "flight_recorder.h"
 #include "utils_conf.h"
 
 #ifdef CONFIG_ASSERT_ENABLE
@@ -101,6 +102,9 @@ void __aeabi_assert(const char *expr, const char *file, int line)
 	printf("assertion failed: %s, file %s, line %s\r\n",
 	       expr, get_file_name(file), p);
 
+	/* The message history leading to the failure */
+	flight_recorder_dump();
+
 	abort();
 }
 
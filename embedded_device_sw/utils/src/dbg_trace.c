@@ -22,43 +22,416 @@
 #include "object.h"
 #include "err.h"
 #include "drv_uart.h"
+#include "dbg_trace.h"
 #include "utils_conf.h"
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+#include "cmsis_os2.h"
+#include "mpsc_ring.h"
+#endif
+
 #ifdef CONFIG_DBG_TRACE_ENABLE
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+
+#define DBG_TRACE_FLAG_WAKEUP   0x00000001u
+#define DBG_TRACE_SPEC_MAX_LEN  16
+
+#if (CONFIG_DBG_TRACE_ARG_NUM > 32)
+#error "CONFIG_DBG_TRACE_ARG_NUM must fit the copied mask."
+#endif
+
+#if defined(__CC_ARM)
+extern const char Image$$ER_IROM1$$Base[];
+extern const char Image$$ER_IROM1$$Limit[];
+#endif
+#endif
+
 /**
  * @brief   Dbg trace handle definition.
  */
 typedef struct {
 	const object *port;
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+	osThreadId_t	thread_id;
+	mpsc_ring_t	ring;
+	unsigned int	drop_num;
+	char		trace_buff[CONFIG_DBG_TRACE_MAX_LEN];
+#endif
 } dbg_trace_handle_t;
 
 static dbg_trace_handle_t dbg_trace_handle;
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+static uint32_t dbg_trace_ring_buff[CONFIG_DBG_TRACE_RING_LENGTH *
+				    MPSC_RING_SLOT_WORDS(
+					    sizeof(dbg_trace_record_t))];
+
+static const osThreadAttr_t dbg_trace_thread_attr = {
+	.name		= CONFIG_DBG_TRACE_THREAD_NAME,
+	.attr_bits	= osThreadDetached,
+	.cb_mem		= NULL,
+	.cb_size	= 0,
+	.stack_mem	= NULL,
+	.stack_size	= CONFIG_DBG_TRACE_THREAD_STACK_SIZE,
+	.priority	= CONFIG_DBG_TRACE_THREAD_PRIORITY,
+};
+#endif
+
 /**
- * @brief   Output the formatted data to UART.
+ * @brief   Format the data and write it to UART.
+ *
+ * @param   port Pointer to the uart object handle.
+ * @param   format The format string.
+ * @param   args The arguments.
  *
  * @retval  The number of data bytes write to the slave on success,
  *          negative error code otherwise.
  */
-int dbg_trace_output(const char *format, ...)
+static int dbg_trace_write(const object *port, const char *format,
+			   va_list args)
 {
 	char trace_buff[CONFIG_DBG_TRACE_MAX_LEN];
 	int len;
 	int ret;
 
-	if (!dbg_trace_handle.port)
+	len = vsnprintf(trace_buff, CONFIG_DBG_TRACE_MAX_LEN, format, args);
+	if (len < 0)
+		return -EINVAL;
+
+	if (len >= CONFIG_DBG_TRACE_MAX_LEN)
+		len = CONFIG_DBG_TRACE_MAX_LEN - 1;
+
+	ret = uart_write(port, trace_buff, len);
+	if (ret < 0)
 		return -EIO;
 
+	return ret;
+}
+
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+/**
+ * @brief   Parse a conversion specification.
+ *
+ * @param   spec Pointer to the '%' of the specification.
+ * @param   conv Pointer to the conversion character found.
+ *
+ * @retval  Returns the pointer after the specification,
+ *          NULL if it can not be deferred.
+ *
+ * @note    Only the conversions of one word are deferred, 'l', 'll', 'j',
+ *          floating point and '*' are formatted in the caller.
+ */
+static const char *dbg_trace_parse_spec(const char *spec, char *conv)
+{
+	const char *p = spec + 1;
+
+	while ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+'
+	       || *p == ' ' || *p == '#' || *p == '.' || *p == 'h')
+		p++;
+
+	switch (*p) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+	case 'c':
+	case 's':
+	case 'p':
+	case '%':
+		break;
+	default:
+		return NULL;
+	}
+
+	if (p - spec >= DBG_TRACE_SPEC_MAX_LEN - 1)
+		return NULL;
+
+	*conv = *p;
+
+	return p + 1;
+}
+
+/**
+ * @brief   Check whether a string lives as long as the image.
+ *
+ * @param   str Pointer to the string.
+ *
+ * @retval  Returns 1 if the string is in the read only image, 0 otherwise.
+ */
+static int dbg_trace_is_static(const char *str)
+{
+#if defined(__CC_ARM)
+	return str >= Image$$ER_IROM1$$Base && str < Image$$ER_IROM1$$Limit;
+#else
+	(void)str;
+
+	return 0;
+#endif
+}
+
+/**
+ * @brief   Store the format and the arguments into a record.
+ *
+ * @param   record Pointer to the record.
+ * @param   format The format string.
+ * @param   args The arguments.
+ *
+ * @retval  Returns 0 on success, -ENOSUPPORT if the format is not in the
+ *          read only image or a specification can not be deferred, -E2BIG
+ *          if the arguments do not fit the record.
+ *
+ * @note    Only the pointer of the format is stored. The strings of '%s'
+ *          outside the read only image are copied, up to their precision.
+ */
+int dbg_trace_record(dbg_trace_record_t *record, const char *format,
+		     va_list args)
+{
+	const char *p = format;
+	const char *spec;
+	const char *str;
+	const char *dot;
+	unsigned int str_len = 0;
+	unsigned int max;
+	unsigned int num = 0;
+	unsigned int i;
+	char conv;
+
+	/* The format may be gone when the record is formatted */
+	if (!dbg_trace_is_static(format))
+		return -ENOSUPPORT;
+
+	record->format = format;
+	record->copied = 0;
+
+	while ((p = strchr(p, '%')) != NULL) {
+		spec = p;
+		p = dbg_trace_parse_spec(p, &conv);
+		if (!p)
+			return -ENOSUPPORT;
+
+		if (conv == '%')
+			continue;
+
+		if (num >= CONFIG_DBG_TRACE_ARG_NUM)
+			return -E2BIG;
+
+		if (conv == 'p') {
+			record->arg[num++].ptr = va_arg(args, const void *);
+			continue;
+		}
+
+		if (conv != 's') {
+			record->arg[num++].value = va_arg(args, unsigned int);
+			continue;
+		}
+
+		str = va_arg(args, const char *);
+		if (!str)
+			return -EINVAL;
+
+		if (dbg_trace_is_static(str)) {
+			record->arg[num++].ptr = str;
+			continue;
+		}
+
+		/* The string may be gone when the record is formatted */
+		max = ~0u;
+		dot = memchr(spec, '.', p - spec);
+		if (dot) {
+			max = 0;
+			while (*++dot >= '0' && *dot <= '9')
+				max = max * 10 + (*dot - '0');
+		}
+
+		for (i = 0; ; i++) {
+			if (str_len + i >= sizeof(record->str))
+				return -E2BIG;
+
+			if (i >= max || !str[i]) {
+				record->str[str_len + i] = '\0';
+				break;
+			}
+
+			record->str[str_len + i] = str[i];
+		}
+
+		record->copied |= 1u << num;
+		record->arg[num++].value = str_len;
+		str_len += i + 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief   Format a record.
+ *
+ * @param   record Pointer to the record.
+ * @param   buff Pointer to the output buffer.
+ * @param   size Size of the output buffer.
+ *
+ * @retval  The length of the output.
+ */
+int dbg_trace_format(const dbg_trace_record_t *	record,
+		     char *				buff,
+		     int				size)
+{
+	char spec[DBG_TRACE_SPEC_MAX_LEN];
+	const char *p = record->format;
+	const char *next;
+	unsigned int num = 0;
+	int len = 0;
+	int ret;
+	char conv;
+
+	while (*p && len < size - 1) {
+		if (*p != '%') {
+			buff[len++] = *p++;
+			continue;
+		}
+
+		/* The record was only made if all the specifications parse */
+		next = dbg_trace_parse_spec(p, &conv);
+
+		if (conv == '%') {
+			buff[len++] = '%';
+			p = next;
+			continue;
+		}
+
+		(void)memcpy(spec, p, next - p);
+		spec[next - p] = '\0';
+		p = next;
+
+		if (record->copied & (1u << num))
+			ret = snprintf(&buff[len], size - len, spec,
+				       &record->str[record->arg[num++].value]);
+		else if (conv == 's' || conv == 'p')
+			ret = snprintf(&buff[len], size - len, spec,
+				       record->arg[num++].ptr);
+		else
+			ret = snprintf(&buff[len], size - len, spec,
+				       record->arg[num++].value);
+
+		if (ret < 0)
+			break;
+
+		len += ret;
+	}
+
+	if (len > size - 1)
+		len = size - 1;
+
+	buff[len] = '\0';
+
+	return len;
+}
+
+/**
+ * @brief   Trace thread, formats the records and writes them to UART.
+ *
+ * @param   argument Pointer to the dbg trace handle.
+ *
+ * @retval  None.
+ */
+static void dbg_trace_thread(void *argument)
+{
+	dbg_trace_handle_t *handle = (dbg_trace_handle_t *)argument;
+	dbg_trace_record_t record;
+	unsigned int drop_num;
+	int len;
+
+	while (1) {
+		while (!mpsc_ring_read(&handle->ring, &record)) {
+			len = dbg_trace_format(&record,
+					       handle->trace_buff,
+					       CONFIG_DBG_TRACE_MAX_LEN);
+
+			(void)uart_write(handle->port, handle->trace_buff, len);
+		}
+
+		drop_num = handle->ring.drop_num;
+		if (drop_num != handle->drop_num) {
+			len = snprintf(handle->trace_buff,
+				       CONFIG_DBG_TRACE_MAX_LEN,
+				       "[DBG TRACE] %u traces dropped\r\n",
+				       drop_num - handle->drop_num);
+			handle->drop_num = drop_num;
+
+			(void)uart_write(handle->port, handle->trace_buff, len);
+		}
+
+		/* The timeout covers a wakeup lost to a racing writer */
+		(void)osThreadFlagsWait(DBG_TRACE_FLAG_WAKEUP,
+					osFlagsWaitAny,
+					CONFIG_DBG_TRACE_FLUSH_MS *
+					osKernelGetTickFreq() / 1000);
+	}
+}
+#endif
+
+/**
+ * @brief   Output the formatted data to UART.
+ *
+ * @retval  The number of data bytes write to the slave on success,
+ *          negative error code otherwise.
+ *
+ * @note    In deferred mode the format and the arguments are queued and
+ *          formatted by the trace thread, 0 is returned once queued. The
+ *          strings of '%s' outside the read only image are copied into the
+ *          record. Formats which can not be deferred, or whose arguments do
+ *          not fit the record, are formatted in the caller, except in an
+ *          interrupt handler where the port can not be taken: the trace is
+ *          dropped and counted with the traces the ring refused.
+ */
+int dbg_trace_output(const char *format, ...)
+{
 	va_list args;
-	va_start(args, format);
-	len = vsnprintf(trace_buff, CONFIG_DBG_TRACE_MAX_LEN, format, args);
-	va_end(args);
+	int ret;
 
-	ret = uart_write(dbg_trace_handle.port, trace_buff, len);
-	if (ret < 0)
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+	dbg_trace_record_t record;
+	int empty;
+#endif
+
+	if (!dbg_trace_handle.port)
 		return -EIO;
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+	if (dbg_trace_handle.thread_id) {
+		va_start(args, format);
+		ret = dbg_trace_record(&record, format, args);
+		va_end(args);
+
+		if (!ret) {
+			empty = mpsc_ring_is_empty(&dbg_trace_handle.ring);
+
+			ret = mpsc_ring_write(&dbg_trace_handle.ring, &record);
+			if (ret)
+				return ret;
+
+			/* The thread drains the ring, it only waits on empty */
+			if (empty)
+				(void)osThreadFlagsSet(dbg_trace_handle.thread_id,
+						       DBG_TRACE_FLAG_WAKEUP);
+
+			return 0;
+		}
+	}
+
+	if (__get_IPSR()) {
+		mpsc_ring_atomic_inc(&dbg_trace_handle.ring.drop_num);
+		return -EBUSY;
+	}
+#endif
+
+	va_start(args, format);
+	ret = dbg_trace_write(dbg_trace_handle.port, format, args);
+	va_end(args);
+
 	return ret;
 }
 
@@ -73,12 +446,32 @@ static int dbg_trace_probe(const object *obj)
 {
 	dbg_trace_handle_t *handle = (dbg_trace_handle_t *)obj->object_data;
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+	int ret;
+#endif
+
 	(void)memset(handle, 0, sizeof(dbg_trace_handle_t));
 
 	handle->port = object_get_binding(CONFIG_DBG_TRACE_PORT_NAME);
 	if (!handle->port)
 		return -ENODEV;
 
+#ifdef CONFIG_DBG_TRACE_DEFERRED_ENABLE
+	ret = mpsc_ring_init(&handle->ring,
+			     dbg_trace_ring_buff,
+			     CONFIG_DBG_TRACE_RING_LENGTH,
+			     sizeof(dbg_trace_record_t));
+	if (ret)
+		return ret;
+
+	/* The traces are formatted in the caller until the thread runs */
+	handle->thread_id = osThreadNew(dbg_trace_thread,
+					handle,
+					&dbg_trace_thread_attr);
+	if (!handle->thread_id)
+		return -ENOMEM;
+#endif
+
 	return 0;
 }
 
@@ -102,4 +495,8 @@ module_early_driver(CONFIG_DBG_TRACE_NAME,
 		    dbg_trace_shutdown,
 		    NULL, &dbg_trace_handle, NULL);
 
+DECLARE_OBJECT_DEPENDS(CONFIG_DBG_TRACE_NAME,
+		       CONFIG_DBG_TRACE_LABEL,
+		       CONFIG_DBG_TRACE_PORT_NAME);
+
 #endif
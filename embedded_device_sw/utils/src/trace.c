@@ -124,4 +124,8 @@ module_early_driver(CONFIG_TRACE_NAME,
 		    trace_shutdown,
 		    NULL, &trace_handle, NULL);
 
+DECLARE_OBJECT_DEPENDS(CONFIG_TRACE_NAME,
+		       CONFIG_TRACE_LABEL,
+		       CONFIG_TRACE_PORT_NAME);
+
 #endif